@@ -60,6 +60,19 @@ void task_manager_delete(TaskManager *manager);
  */
 int task_manager_insert(TaskManager *manager, task_t *task);
 
+/**
+ * @brief Moves every task of a queue into the task queue.
+ *
+ * The tasks are inserted in order, like task_manager_insert, but the whole
+ * queue is merged in a single pass.
+ *
+ * @param manager Pointer for the Task Manager
+ * @param queue Pointer for the queue with the tasks. It is empty at the end.
+ *
+ * @return The number of tasks inserted, or 0> if something went wrong.
+ */
+int task_manager_splice(TaskManager *manager, task_t **queue);
+
 /**
  * @brief Remove a task of the task queue.
  *
@@ -83,6 +83,25 @@ int queue_append(queue_t **queue, queue_t *elem);
 int queue_insert_inorder(queue_t **queue, queue_t *elem,
                          int (*compare)(const void *ptr1, const void *ptr2));
 
+/**
+ * @brief Moves every element of another queue into the queue, in order.
+ *
+ * The elements of the other queue are sorted and merged with the queue in a
+ * single pass, instead of being inserted one at a time. The result is the same
+ * as calling queue_insert_inorder with each element, from the first to the
+ * last, as long as the queue is already in order. At the end the other queue
+ * is empty.
+ *
+ * @param queue Pointer for the queue that is going to receive the elements
+ * @param other Pointer for the queue with the elements to be moved
+ * @param compare Function used to determine the order, with the same meaning
+ * of the one used in queue_insert_inorder.
+ *
+ * @return The number of elements moved, <0 if something went wrong
+ */
+int queue_merge_inorder(queue_t **queue, queue_t **other,
+                        int (*compare)(const void *ptr1, const void *ptr2));
+
 /**
  * @brief Removes the element in the queue.
  *
@@ -39,6 +39,15 @@ void ppos_init();
  */
 unsigned int systime();
 
+/**
+ * @brief Gets the execution time of the system with nanosecond resolution.
+ *
+ * The time is read from a monotonic clock, and not from the timer interrupt.
+ *
+ * @return The total time of the system since execution, in nanoseconds.
+ */
+unsigned long long systime_ns();
+
 //=============================================================================
 // Task Management
 //=============================================================================
@@ -70,6 +79,9 @@ int task_switch(task_t *task);
 /**
  * @brief Ends the current task.
  *
+ * The termination code of the main task is the exit status of the process, once
+ * every task finished.
+ *
  * @param exit_code Termination code returned by the task
  */
 void task_exit(int exit_code);
@@ -114,6 +126,57 @@ int task_getprio(const task_t *const task);
  */
 int task_setprio(task_t *task, int prio);
 
+/**
+ * @brief Sets the quantum of the tasks of each priority.
+ *
+ * Each time a task is scheduled it gets the quantum of its priority, so the
+ * tasks with a low priority, that usually process in batch, can execute for
+ * longer and switch less often than the interactive ones. By default every
+ * priority gets TASK_QUANTUM.
+ *
+ * @param table Array with QUANTUM_LEVELS quanta in milliseconds, the first one
+ * for TASK_MIN_PRIO and the last one for TASK_MAX_PRIO. If NULL every priority
+ * gets TASK_QUANTUM again.
+ *
+ * @return 0 on success, and -1 if a quantum is not positive.
+ */
+int task_set_quantum_table(const int *table);
+
+/**
+ * @brief Sets the quantum of a task, instead of the one of its priority.
+ *
+ * @param task Pointer for the task, or NULL for the executing one
+ * @param quantum Quantum in milliseconds, or 0 to use the one of the priority
+ * again
+ *
+ * @return 0 on success, and -1 if the quantum is negative.
+ */
+int task_set_quantum(task_t *task, int quantum);
+
+/**
+ * @brief Gets the quantum of a task.
+ *
+ * @param task Pointer for the task, or NULL for the executing one
+ *
+ * @return The quantum that the task gets when scheduled, in milliseconds.
+ */
+int task_get_quantum(const task_t *task);
+
+/**
+ * @brief Gets the time a task spent in each state
+ *
+ * The time is measured with the monotonic clock whenever the task changes of
+ * state, so even executions shorter than a tick are accounted. The time in the
+ * current state is included.
+ *
+ * @param task Pointer for the task, or NULL for the current one
+ * @param times Pointer that receives the execution, ready and blocked time of
+ * the task, in nanoseconds
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int task_times(const task_t *task, task_times_t *times);
+
 /**
  * @brief Waits for a task to complete.
  *
@@ -127,10 +190,39 @@ int task_setprio(task_t *task, int prio);
  */
 int task_wait(task_t *task);
 
+/**
+ * @brief Waits for every task of a set to complete.
+ *
+ * Suspends the current task only once, until all the tasks passed have
+ * finished. Tasks that already finished are not waited.
+ *
+ * @param tasks Array with the pointers for the tasks being waited.
+ * @param num Number of tasks in the array.
+ * @param exit_codes Array that receives the exit value of each task, or NULL.
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int task_wait_all(task_t **tasks, int num, int *exit_codes);
+
+/**
+ * @brief Waits for the first task of a set to complete.
+ *
+ * Suspends the current task until one of the tasks passed has finished. If
+ * some task already finished, returns right away.
+ *
+ * @param tasks Array with the pointers for the tasks being waited.
+ * @param num Number of tasks in the array.
+ * @param exit_code Pointer that receives the exit value of the task, or NULL.
+ *
+ * @return The index of the task that finished, and -1 on error.
+ */
+int task_wait_any(task_t **tasks, int num, int *exit_code);
+
 /**
  * @brief Suspends the current task.
  *
- * Place the current task into the suspending queue.
+ * Place the current task into the suspending queue. The call can be made while
+ * holding the big kernel lock, which is released once the task executes again.
  *
  * @param queue Suspending queue that is going to receive the suspended task.
  */
@@ -146,6 +238,18 @@ void task_suspend(task_t **queue);
  */
 void task_awake(task_t *task, task_t **queue);
 
+/**
+ * @brief Awake every task suspended in the queue.
+ *
+ * Moves all the tasks of the queue into the ready queue at once, keeping the
+ * same order as if they were awakened one by one from the first.
+ *
+ * @param queue Pointer for the queue of suspended tasks. It is empty at the end.
+ *
+ * @return The number of tasks awakened.
+ */
+int task_awake_all(task_t **queue);
+
 /**
  * @brief Make the current task sleep.
  *
@@ -157,6 +261,210 @@ void task_awake(task_t *task, task_t **queue);
  */
 void task_sleep(int time);
 
+/**
+ * @brief Make the current task sleep until an absolute time.
+ *
+ * The task is awakened by the first tick after the deadline, and never before
+ * it, so the time spent executing before the call does not delay the next
+ * wakeup, as it does with a relative sleep.
+ *
+ * @param deadline System time to awake the task, in nanoseconds, as returned
+ * by systime_ns()
+ *
+ * @return 0 after sleeping, or 1 if the deadline had already passed, where the
+ * task returns without yielding.
+ */
+int task_sleep_until(unsigned long long deadline);
+
+/**
+ * @brief Make the current task sleep until its next period.
+ *
+ * Advances the deadline by one period and sleeps until it. Each deadline
+ * follows the previous one, so the wakeups of a periodic loop do not drift
+ * with the execution time or with the wakeup latency. A late task returns
+ * immediately until it catches up with its deadlines.
+ *
+ * @param deadline Pointer for the last deadline, in nanoseconds. Starts with
+ * systime_ns() and is updated to the new deadline.
+ * @param period Interval between the deadlines, in nanoseconds
+ *
+ * @return 0 after sleeping, 1 if the new deadline had already passed, and -1
+ * if the parameters are invalid.
+ */
+int task_sleep_next(unsigned long long *deadline, unsigned long long period);
+
+/**
+ * @brief Sets the slack of the wakeups of a task
+ *
+ * A sleeping task may be awakened at any time between its sleep time and the
+ * slack after it, so the wakeups of tasks that sleep until close times are
+ * handled together, by a single pass of the dispatcher. The releases of a
+ * periodic task have no slack.
+ *
+ * @param task Pointer for the task, or NULL for the current one
+ * @param slack Maximum delay of each wakeup, in milliseconds, or 0 to awake
+ * the task exactly on time
+ *
+ * @return 0 on success, and -1 if the slack is negative.
+ */
+int task_set_slack(task_t *task, int slack);
+
+/**
+ * @brief Sets the priority gap of the wakeup preemption
+ *
+ * A task awakened, by another task or once its sleep is over, preempts the
+ * executing task right away when its priority is higher by more than the gap.
+ * Otherwise it waits in the ready queue until the executing task leaves the
+ * processor. A real-time task always preempts a time-sharing one. The gap is 0
+ * by default, so only a task with a higher priority preempts.
+ *
+ * @param gap Difference between the priorities, from -1, where a task with
+ * the same priority also preempts, to TASK_MAX_PRIO - TASK_MIN_PRIO, where the
+ * time-sharing tasks are never preempted on a wakeup
+ *
+ * @return 0 on success, and -1 if the gap is out of the range.
+ */
+int task_set_wakeup_gap(int gap);
+
+/**
+ * @brief Disables the preemption of the current task
+ *
+ * The calls nest, and the task can only be preempted again after the same
+ * number of calls to preempt_enable(). A tick that would preempt the task
+ * meanwhile is not lost, the task leaves the processor as soon as the
+ * preemption is enabled again. The task must not suspend in between.
+ */
+void preempt_disable();
+
+/**
+ * @brief Enables the preemption of the current task
+ *
+ * @return 0 on success, and -1 if the preemption was not disabled.
+ */
+int preempt_enable();
+
+/**
+ * @brief Moves the current task to the real-time class
+ *
+ * The ready tasks of the real-time class always execute before the ones of the
+ * time-sharing class, the one with the earliest deadline first. The first job
+ * is released when the function is called, and each job ends calling
+ * task_wait_period(). A job that consumes all of its budget is suspended until
+ * the next release, where it continues with a new budget and deadline. Passing
+ * 0 to all the parameters moves the task back to the time-sharing class.
+ *
+ * @param period Interval between the releases of the jobs, in milliseconds
+ * @param deadline Deadline of each job relative to its release, in
+ * milliseconds. Must not be greater than the period.
+ * @param budget Processor time of each job, in milliseconds. Must not be
+ * greater than the deadline.
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int task_set_periodic(int period, int deadline, int budget);
+
+/**
+ * @brief Ends the job of the current periodic task
+ *
+ * Suspends the task until the release of its next job. If the next job was
+ * already released, returns immediately.
+ *
+ * @return 0 on success, and -1 if the task is not periodic.
+ */
+int task_wait_period();
+
+/**
+ * @brief Gets the counters of a periodic task
+ *
+ * @param task Pointer for the task, or NULL for the current one
+ * @param stats Pointer that receives the jobs completed, the deadlines missed,
+ * and the times the task consumed all the budget of a job
+ *
+ * @return 0 on success, and -1 if the task is not periodic.
+ */
+int task_rt_stats(const task_t *task, task_rt_stats_t *stats);
+
+//=============================================================================
+// Software Timer Management
+//=============================================================================
+
+/**
+ * @brief Arms a software timer
+ *
+ * The callback is executed by the dispatcher, on the first pass after the
+ * timer expired, without a task or a stack of its own. So it must not suspend,
+ * but it may wake tasks up, as releasing a semaphore, or arm and cancel
+ * timers. An armed timer keeps the system executing, as a sleeping task.
+ *
+ * @param timer Pointer for the timer, that must not be armed
+ * @param delay Time until the first expiration, in milliseconds
+ * @param period Interval between the next expirations, in milliseconds, or 0
+ * for a timer that expires only once
+ * @param callback Function executed on each expiration
+ * @param arg Argument passed to the function
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int ppos_timer_create(ppos_timer_t *timer, int delay, int period,
+                      void (*callback)(void *), void *arg);
+
+/**
+ * @brief Disarms a software timer
+ *
+ * After this function returns the callback is not executed again, and the
+ * timer can be armed again.
+ *
+ * @param timer Pointer for the timer
+ *
+ * @return 0 if the timer was armed, and -1 otherwise.
+ */
+int ppos_timer_cancel(ppos_timer_t *timer);
+
+//=============================================================================
+// CPU Budget Management
+//=============================================================================
+
+/**
+ * @brief Initializes a reservation of processor for a group of tasks
+ *
+ * The tasks attached to the budget execute, all together, for at most the
+ * runtime in each period. Once the runtime is over, the task executing leaves
+ * the processor on the next tick, and the tasks of the group are parked as
+ * they would execute, until the budget is replenished at the end of the
+ * period. The budget counts the periods where the group used all of its
+ * runtime, in num_depleted, and the times a task was parked, in num_throttles.
+ *
+ * @param budget Pointer for the budget
+ * @param runtime Processor time of the group in each period, in milliseconds
+ * @param period Interval between the replenishments, in milliseconds. Must not
+ * be less than the runtime.
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int cpu_budget_init(cpu_budget_t *budget, int runtime, int period);
+
+/**
+ * @brief Attaches a task to a reservation of processor
+ *
+ * A task belongs to a single group, and leaves the one where it was, if any.
+ *
+ * @param budget Pointer for the budget, or NULL to leave the group without
+ * joining another
+ * @param task Pointer for the task, or NULL for the current one
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int cpu_budget_attach(cpu_budget_t *budget, task_t *task);
+
+/**
+ * @brief Destroys a reservation of processor
+ *
+ * @param budget Pointer for the budget
+ *
+ * @return 0 on success, and -1 if there are tasks still attached to it.
+ */
+int cpu_budget_destroy(cpu_budget_t *budget);
+
 //=============================================================================
 // Mutex Management
 //=============================================================================
@@ -175,7 +483,8 @@ int mutex_init(mutex_t *mutex);
 /**
  * @brief Destroy the mutex structure
  *
- * Destroy the mutex passed by the pointer.
+ * Destroy the mutex passed by the pointer, and wake up all the tasks that were
+ * waiting for this mutex. This tasks return from the lock with a error code.
  *
  * @param mutex Pointer for the mutex to be destroyed
  *
@@ -186,27 +495,142 @@ int mutex_destroy(mutex_t *mutex);
 /**
  * @brief Lock this mutex
  *
- * Lock this mutex preventing another task from entering this location. Calls in
- * the mutex are non blocking.
+ * Lock this mutex preventing another task from entering this location. This
+ * call can block, if the mutex is already locked the current task is suspended,
+ * and inserted in the end of the queue of the mutex, after yielding the number
+ * of times set by mutex_spin. While there are tasks
+ * waiting, the owner of the mutex inherits the highest priority between them.
  *
  * @param mutex Pointer for the mutex that is going to be locked.
  *
- * @return 1 if the mutex was locked, and 0 otherwise, and -1 if something went
- * wrong.
+ * @return 0 if the mutex was locked, and -1 if something went wrong or the
+ * mutex was destroyed while waiting.
  */
 int mutex_lock(mutex_t *mutex);
 
+/**
+ * @brief Sets how long a task waits for this mutex before suspending
+ *
+ * Before suspending, a task that finds the mutex locked yields up to limit
+ * times, trying to get it again after each one. The yields are skipped if the
+ * mutex is held on average for longer than SPIN_MAX_HOLD, or if the owner has a
+ * lower priority than the task, as it would not execute. The statistics are
+ * kept in the hold_avg, num_spins and num_spin_acquires fields of the mutex.
+ *
+ * @param mutex Pointer for the mutex
+ * @param limit Max number of yields (SPIN_LIMIT by default). 0 suspends the
+ * task right away.
+ *
+ * @return 0 if the limit could be set, and -1 otherwise.
+ */
+int mutex_spin(mutex_t *mutex, int limit);
+
+/**
+ * @brief Sets the order in which the tasks waiting for this mutex are served
+ *
+ * By default (WAIT_FIFO) the mutex is handed to the waiting tasks in the order
+ * they arrived. With WAIT_PRIO it is handed to the most important waiting task,
+ * and in arrival order between tasks of the same priority. A waiting task whose
+ * priority changes, as when it inherits one, moves to its new place. Both
+ * insertion and removal take constant time.
+ *
+ * @param mutex Pointer for the mutex
+ * @param policy WAIT_FIFO or WAIT_PRIO
+ *
+ * @return 0 if the order could be set, and -1 otherwise or if there are tasks
+ * waiting for the mutex.
+ */
+int mutex_setorder(mutex_t *mutex, wait_policy policy);
+
 /**
  * @brief Unlock this mutex
  *
- * Unlock the mutex passed. Calls in the lock and unlock are non blocking.
+ * Unlock the mutex passed, restoring the priority of the owner. If there is
+ * some task waiting in the queue, the mutex is handed directly to the first one
+ * in the queue when the current task leaves the processor, unless the current
+ * task locks it again before that. This call is non blocking.
  *
  * @param task Pointer for the mutex that is going to be unlocked
  *
- * @return 0 if the mutex could be unlocked, and 1 otherwise.
+ * @return 0 if the mutex could be unlocked, and -1 if something went wrong or
+ * the current task does not hold the mutex.
  */
 int mutex_unlock(mutex_t *mutex);
 
+//=============================================================================
+// Condition Variable Management
+//=============================================================================
+
+/**
+ * @brief Initializes the condition variable structure.
+ *
+ * @param cond Pointer for the condition variable that is going to be
+ * initialized
+ *
+ * @return 0 if successfuly initialized, and -1 if something went wrong.
+ */
+int cond_init(cond_t *cond);
+
+/**
+ * @brief Destroy the condition variable
+ *
+ * Destroy the condition variable passed by the pointer, and wake up all the
+ * tasks that were waiting for it. This tasks return from the wait with a error
+ * code, without holding the mutex. The tasks already signaled, but that did not
+ * get the mutex yet, still return from the wait as signaled.
+ *
+ * @param cond Pointer for the condition variable to be destroyed
+ *
+ * @return 0 if successfuly destroyed, and -1 otherwise.
+ */
+int cond_destroy(cond_t *cond);
+
+/**
+ * @brief Waits for the condition to be signaled
+ *
+ * Unlocks the mutex and suspends the current task in the queue of the condition
+ * variable, in a single step. The mutex is locked again before returning 0.
+ * Every task waiting at the same time must use the same mutex.
+ *
+ * When returning -1 the current task does not hold the mutex, so it must not
+ * unlock it. If the condition variable was destroyed while waiting, the mutex
+ * is still taken in turn and unlocked before returning. A signal wins over a
+ * later destruction, so a task signaled before it returns 0.
+ *
+ * @param cond Pointer for the condition variable
+ * @param mutex Pointer for the mutex, that must be locked by the current task
+ *
+ * @return 0 on success, and -1 if something went wrong, or if the condition
+ * variable or the mutex were destroyed while waiting.
+ */
+int cond_wait(cond_t *cond, mutex_t *mutex);
+
+/**
+ * @brief Wakes up the first task waiting for the condition
+ *
+ * The task is moved straight to the queue of the mutex, so it only gets to
+ * execute once the mutex can be handed to it. This call is non blocking.
+ *
+ * @param cond Pointer for the condition variable
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int cond_signal(cond_t *cond);
+
+/**
+ * @brief Wakes up every task waiting for the condition
+ *
+ * The tasks are moved straight to the queue of the mutex, instead of the ready
+ * queue, so each one only executes once the mutex is handed to it, instead of
+ * all of them competing for the mutex at the same time. This call is non
+ * blocking.
+ *
+ * @param cond Pointer for the condition variable
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int cond_broadcast(cond_t *cond);
+
 //=============================================================================
 // Semaphore Management
 //=============================================================================
@@ -241,7 +665,10 @@ int sem_destroy(semaphore_t *sem);
  *
  * Release the semaphore, adding 1 to the value stored inside the structure.
  * This call is non blocking. If there is some task waiting in the queue, the
- * first one in the queue is going to be placed in the ready queue.
+ * unit is handed directly to the first one in the queue, right away if it is
+ * more important than the current task, or otherwise when the current task
+ * leaves the processor. Until then the unit is reserved to it, so neither the
+ * current task nor any other one can take it back.
  *
  * @param sem Pointer for the semaphore that is going to be released
  *
@@ -249,19 +676,157 @@ int sem_destroy(semaphore_t *sem);
  */
 int sem_up(semaphore_t *sem);
 
+/**
+ * @brief Releases n units of the semaphore at once
+ *
+ * Works like sem_up, adding n to the value of the semaphore. The waiting tasks
+ * are served in the order of the queue, and every task that can proceed with
+ * the units available is awakened in a single pass.
+ *
+ * @param sem Pointer for the semaphore that is going to be released
+ * @param n Number of units released
+ *
+ * @return 0 if  the switch was successful, and 0< otherwise.
+ */
+int sem_up_n(semaphore_t *sem, int n);
+
 /**
  * @brief Locks this semaphore
  *
  * Try to lock the semaphore passed. This call can block, if the value inside
- * the semaphore is negative, the current task is suspended, and inserted in the
- * end of the queue of the semaphore.
+ * the semaphore is not positive, the current task is suspended, and inserted in
+ * the end of the queue of the semaphore, after yielding the number of times set
+ * by sem_spin. A suspended task is only awakened when a unit was handed to it by
+ * sem_up, so it never needs to wait again.
  *
  * @param task Pointer for the semaphore that is going to be locked
  *
- * @return 0 if the lock happened, and -1 if something went wrong.
+ * @return 0 if the lock happened, and -1 if something went wrong or the
+ * semaphore was destroyed while waiting.
  */
 int sem_down(semaphore_t *sem);
 
+/**
+ * @brief Takes n units of the semaphore at once
+ *
+ * Works like sem_down, but the task only proceeds when all the n units are
+ * available, and they are all taken together. A suspended task is only
+ * awakened when all its units were handed to it. No task takes units while
+ * others wait before it, so a task waiting for many units is not starved by
+ * the ones taking a few at a time.
+ *
+ * @param sem Pointer for the semaphore that is going to be locked
+ * @param n Number of units taken
+ *
+ * @return 0 if the lock happened, and -1 if something went wrong or the
+ * semaphore was destroyed while waiting.
+ */
+int sem_down_n(semaphore_t *sem, int n);
+
+/**
+ * @brief Sets how long a task waits for this semaphore before suspending
+ *
+ * Before suspending, a task that finds no unit available yields up to limit
+ * times, trying to get a unit again after each one. The yields are skipped if
+ * the units are held on average for longer than SPIN_MAX_HOLD. The statistics
+ * are kept in the hold_avg, num_spins and num_spin_acquires fields of the
+ * semaphore.
+ *
+ * @param sem Pointer for the semaphore
+ * @param limit Max number of yields (SPIN_LIMIT by default). 0 suspends the
+ * task right away.
+ *
+ * @return 0 if the limit could be set, and -1 otherwise.
+ */
+int sem_spin(semaphore_t *sem, int limit);
+
+/**
+ * @brief Sets the order in which the tasks waiting for this semaphore are served
+ *
+ * By default (WAIT_FIFO) the units are handed to the waiting tasks in the order
+ * they arrived. With WAIT_PRIO they are handed to the most important waiting
+ * task first, and in arrival order between tasks of the same priority, so a
+ * task with a high priority does not wait behind the ones with a low priority.
+ * A waiting task whose priority changes, as when it inherits one, moves to its
+ * new place. Both insertion and removal take constant time.
+ *
+ * @param sem Pointer for the semaphore
+ * @param policy WAIT_FIFO or WAIT_PRIO
+ *
+ * @return 0 if the order could be set, and -1 otherwise or if there are tasks
+ * waiting for the semaphore.
+ */
+int sem_setorder(semaphore_t *sem, wait_policy policy);
+
+//=============================================================================
+// Reader-Writer Lock Management
+//=============================================================================
+
+/**
+ * @brief Initializes a new reader-writer lock.
+ *
+ * @param rwlock Pointer for the lock
+ * @param pref Who gets the lock first when both readers and writers are
+ * waiting. With RW_PREFER_WRITERS a new reader also waits if there is some
+ * writer waiting, so the writers are not starved by a stream of readers.
+ *
+ * @return 0 if successfuly created, and -1 if something went wrong.
+ */
+int rwlock_init(rwlock_t *rwlock, rwlock_pref pref);
+
+/**
+ * @brief Destroy the reader-writer lock
+ *
+ * Destroy the lock passed by the pointer, and wake up all the tasks that were
+ * waiting for it. This tasks return with a error code.
+ *
+ * @param rwlock Pointer for the lock to be destroyed
+ *
+ * @return 0 if successfuly destroyed, and -1 otherwise.
+ */
+int rwlock_destroy(rwlock_t *rwlock);
+
+/**
+ * @brief Locks for reading
+ *
+ * Any number of readers can hold the lock at the same time. This call can
+ * block, if a writer holds the lock, or if a writer is waiting and writers are
+ * preferred, the current task is suspended until the lock is handed to it.
+ *
+ * @param rwlock Pointer for the lock
+ *
+ * @return 0 if the lock happened, and -1 if something went wrong or the lock
+ * was destroyed while waiting.
+ */
+int rwlock_rdlock(rwlock_t *rwlock);
+
+/**
+ * @brief Locks for writing
+ *
+ * Only one writer can hold the lock, and no reader at the same time. This call
+ * can block, if the lock is held the current task is suspended until the lock
+ * is handed to it.
+ *
+ * @param rwlock Pointer for the lock
+ *
+ * @return 0 if the lock happened, and -1 if something went wrong or the lock
+ * was destroyed while waiting.
+ */
+int rwlock_wrlock(rwlock_t *rwlock);
+
+/**
+ * @brief Unlocks the reader-writer lock
+ *
+ * Releases the lock held by the current task, for reading or writing. Once the
+ * lock is free it is handed to the next writer, or to every waiting reader at
+ * once, following the preference of the lock. This call is non blocking.
+ *
+ * @param rwlock Pointer for the lock
+ *
+ * @return 0 if the lock was released, and -1 otherwise.
+ */
+int rwlock_unlock(rwlock_t *rwlock);
+
 //=============================================================================
 // Barrier Management
 //=============================================================================
@@ -302,6 +867,47 @@ int barrier_destroy(barrier_t *barrier);
  */
 int barrier_join(barrier_t *barrier);
 
+/**
+ * @brief Initializes a new tree barrier.
+ *
+ * The tree barrier combines the arrivals in a tree with TBARRIER_RADIX
+ * children per node, so each arrival only touches the nodes in its path to the
+ * root. The last task to arrive in a node carries the arrival to its parent,
+ * and releases the node when it comes back. The barrier can be used again
+ * right after being released.
+ *
+ * @param barrier Pointer for the tree barrier
+ * @param num Number of tasks waiting this barrier to complete.
+ *
+ * @return 0 if successfuly created, and -1 if something went wrong.
+ */
+int tbarrier_init(tbarrier_t *barrier, int num);
+
+/**
+ * @brief Destroy a tree barrier
+ *
+ * Destroy the barrier passed by the pointer, and wake up all the tasks that are
+ * waiting for this barrier. This tasks return from with a error code.
+ *
+ * @param barrier Pointer for the tree barrier to be destroyed
+ *
+ * @return 0 if successfuly destroyed, and -1 otherwise.
+ */
+int tbarrier_destroy(tbarrier_t *barrier);
+
+/**
+ * @brief Indicates that the task reached this tree barrier
+ *
+ * Each participant has its own index, which decides the leaf where it
+ * arrives. Two tasks must not join the same phase with the same index.
+ *
+ * @param barrier Pointer for the tree barrier, that needs to be joined.
+ * @param id Index of the participant, from 0 to the number of tasks - 1.
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int tbarrier_join(tbarrier_t *barrier, int id);
+
 //=============================================================================
 // Message Queue Management
 //=============================================================================
@@ -317,6 +923,23 @@ int barrier_join(barrier_t *barrier);
  */
 int mqueue_init(mqueue_t *queue, int max_msgs, int msg_size);
 
+/**
+ * @brief Initializes a message queue ordered by priority
+ *
+ * Each message is sent with a priority, and mqueue_recv returns the message
+ * with the highest priority first. Messages with the same priority are received
+ * in the order they were sent. Both operations take constant time.
+ *
+ * @param queue Pointer for the message queue that needs to be initialized
+ * @param max_msgs Max number of messages in the queue.
+ * @param msg_size The size of the messages
+ * @param num_prios Number of priorities, up to MQUEUE_MAX_PRIOS.
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int mqueue_init_prio(mqueue_t *queue, int max_msgs, int msg_size,
+                     int num_prios);
+
 /**
  * @brief Sends a message through the queue
  *
@@ -331,11 +954,26 @@ int mqueue_init(mqueue_t *queue, int max_msgs, int msg_size);
  */
 int mqueue_send(mqueue_t *queue, void *msg);
 
+/**
+ * @brief Sends a message with a priority through the queue
+ *
+ * Works like mqueue_send, but the message is received before every message
+ * with a lower priority. mqueue_send uses the lowest priority of the queue.
+ *
+ * @param queue Pointer for the queue, that is going to receive the message.
+ * @param msg Value that is going to be copied to the queue
+ * @param prio Priority of the message, 0 is the highest one.
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int mqueue_send_prio(mqueue_t *queue, void *msg, int prio);
+
 /**
  * @brief Receives a message that is in the queue
  *
  * Receives the message that is in the beginning of the queue and place this in
- * the msg pointer. This function block the caller, if the queue is empty, the
+ * the msg pointer. In queues ordered by priority, this is the oldest message
+ * with the highest priority. This function block the caller, if the queue is empty, the
  * current task is suspended until there is some message in the queue.
  *
  * @param queue Pointer for the queue, that is sending the message.
@@ -366,4 +1004,329 @@ int mqueue_destroy(mqueue_t *queue);
  */
 int mqueue_msgs(mqueue_t *queue);
 
+/**
+ * @brief Sets the order in which the tasks waiting on the queue are served
+ *
+ * Applies sem_setorder to both the senders waiting for room and the receivers
+ * waiting for messages. Either both orders change or none of them.
+ *
+ * @param queue Pointer for the message queue
+ * @param policy WAIT_FIFO or WAIT_PRIO
+ *
+ * @return 0 if the order could be set, and -1 otherwise or if there are tasks
+ * waiting on the queue.
+ */
+int mqueue_setorder(mqueue_t *queue, wait_policy policy);
+
+//=============================================================================
+// Channel Management
+//=============================================================================
+
+/**
+ * @brief Initializes a channel of variable-length messages.
+ *
+ * Each message is stored in a ring buffer as a record with its length followed
+ * by the payload, so only the bytes actually sent are copied. In CHAN_SPLIT
+ * mode a record can wrap around the end of the buffer, while in CHAN_NOSPLIT
+ * mode the end of the buffer is skipped so every record stays contiguous.
+ *
+ * @param chan Pointer for the channel that needs to be initialized
+ * @param size Size of the buffer in bytes, including the record headers
+ * @param mode How the records are placed at the end of the buffer
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int channel_init(channel_t *chan, int size, channel_mode mode);
+
+/**
+ * @brief Sends a message through the channel
+ *
+ * The caller is suspended until there is space for the whole record.
+ *
+ * @param chan Pointer for the channel, that is going to receive the message.
+ * @param msg Pointer for the payload that is going to be copied
+ * @param len Number of bytes of the payload
+ *
+ * @return 0 on success, and -1 otherwise, or if the record can never fit in the
+ * channel.
+ */
+int channel_send(channel_t *chan, void *msg, int len);
+
+/**
+ * @brief Receives the first message of the channel
+ *
+ * The caller is suspended until there is some message in the channel. If the
+ * message is larger than the buffer it stays in the channel.
+ *
+ * @param chan Pointer for the channel, that is sending the message.
+ * @param msg Pointer to were the message is going to be writted.
+ * @param max Size of the msg buffer in bytes
+ *
+ * @return The length of the message on success, and -1 otherwise.
+ */
+int channel_recv(channel_t *chan, void *msg, int max);
+
+/**
+ * @brief Destroy the channel
+ *
+ * Destroy the channel, and wake up all the tasks waiting for it. This tasks
+ * return with an error code.
+ *
+ * @param chan Pointer for the channel
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int channel_destroy(channel_t *chan);
+
+/**
+ * @brief Indicates the number of messages in the channel
+ *
+ * @param chan Pointer for the channel
+ *
+ * @return 0>= in case of sucess, and a negative value otherwise
+ */
+int channel_msgs(channel_t *chan);
+
+//=============================================================================
+// Broadcast Management
+//=============================================================================
+
+/**
+ * @brief Initializes a broadcast ring
+ *
+ * Each message is written once in the ring, and every subscriber reads it
+ * through its own cursor.
+ *
+ * @param bcast Pointer for the ring that needs to be initialized
+ * @param max_msgs Max number of messages in the ring.
+ * @param msg_size The size of the messages
+ * @param policy BCAST_BLOCK to make the sender wait for the slowest
+ * subscriber, or BCAST_DROP to overwrite the messages it did not read yet.
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int bcast_init(bcast_t *bcast, int max_msgs, int msg_size,
+               bcast_policy policy);
+
+/**
+ * @brief Subscribes to the broadcast ring
+ *
+ * The subscriber receives every message sent after this call.
+ *
+ * @param bcast Pointer for the ring
+ * @param sub Pointer for the subscriber
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int bcast_subscribe(bcast_t *bcast, bcast_sub_t *sub);
+
+/**
+ * @brief Removes the subscriber of its broadcast ring
+ *
+ * @param sub Pointer for the subscriber
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int bcast_unsubscribe(bcast_sub_t *sub);
+
+/**
+ * @brief Sends a message to every subscriber of the ring
+ *
+ * With BCAST_BLOCK the caller is suspended while the slowest subscriber still
+ * needs to read the oldest message of a full ring.
+ *
+ * @param bcast Pointer for the ring, that is going to receive the message.
+ * @param msg Value that is going to be copied to the ring
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int bcast_send(bcast_t *bcast, void *msg);
+
+/**
+ * @brief Receives the next message of the subscriber
+ *
+ * The caller is suspended until there is a message the subscriber did not
+ * read. With BCAST_DROP, a subscriber that lagged a whole ring behind skips to
+ * the oldest message still in the ring, and the lost messages are counted in
+ * num_drops.
+ *
+ * @param sub Pointer for the subscriber
+ * @param msg Pointer to were the message is going to be writted.
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int bcast_recv(bcast_sub_t *sub, void *msg);
+
+/**
+ * @brief Destroy the broadcast ring
+ *
+ * Destroy the ring, and wake up all the tasks waiting for it. This tasks
+ * return with an error code.
+ *
+ * @param bcast Pointer for the ring
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int bcast_destroy(bcast_t *bcast);
+
+//=============================================================================
+// Future Management
+//=============================================================================
+
+/**
+ * @brief Initializes a future without a value.
+ *
+ * @param future Pointer for the future
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int future_init(future_t *future);
+
+/**
+ * @brief Completes the future with a value.
+ *
+ * Every task waiting for the value is awakened. A future can only be completed
+ * once.
+ *
+ * @param future Pointer for the future
+ * @param value Value of the future
+ *
+ * @return 0 on success, and -1 if the future was already completed.
+ */
+int future_complete(future_t *future, void *value);
+
+/**
+ * @brief Gets the value of the future.
+ *
+ * The caller is suspended until the future is completed.
+ *
+ * @param future Pointer for the future
+ * @param value Pointer that receives the value, or NULL.
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int future_get(future_t *future, void **value);
+
+/**
+ * @brief Indicates if the future was completed.
+ *
+ * @param future Pointer for the future
+ *
+ * @return 1 if completed, 0 if not, and -1 on error.
+ */
+int future_done(future_t *future);
+
+/**
+ * @brief Destroy the future
+ *
+ * Destroy the future, and wake up all the tasks waiting for it. This tasks
+ * return with an error code.
+ *
+ * @param future Pointer for the future
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int future_destroy(future_t *future);
+
+//=============================================================================
+// Event Group Management
+//=============================================================================
+
+/**
+ * @brief Initializes an event group.
+ *
+ * @param event Pointer for the event group
+ * @param bits Bits that start set
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int event_init(event_t *event, unsigned int bits);
+
+/**
+ * @brief Sets bits of the event group.
+ *
+ * Every waiting task satisfied by the new bits is awakened in a single pass
+ * over the queue. The bits of the tasks that wait with EVENT_CLEAR are only
+ * cleared after the pass, so every task waiting for the same bits sees them.
+ *
+ * @param event Pointer for the event group
+ * @param bits Bits to be set
+ *
+ * @return The number of tasks awakened, and -1 on error.
+ */
+int event_set(event_t *event, unsigned int bits);
+
+/**
+ * @brief Clears bits of the event group.
+ *
+ * @param event Pointer for the event group
+ * @param bits Bits to be cleared
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int event_clear(event_t *event, unsigned int bits);
+
+/**
+ * @brief Waits for bits of the event group.
+ *
+ * The caller is suspended until any of the bits is set, or all of them with
+ * EVENT_ALL. With EVENT_CLEAR the bits waited are cleared once satisfied.
+ *
+ * @param event Pointer for the event group
+ * @param bits Bits waited
+ * @param flags EVENT_ALL and EVENT_CLEAR, or 0
+ * @param result Pointer that receives the bits of the group when the wait was
+ * satisfied, before being cleared, or NULL.
+ *
+ * @return 0 on success, and -1 otherwise or if the event group was destroyed.
+ */
+int event_wait(event_t *event, unsigned int bits, int flags,
+               unsigned int *result);
+
+/**
+ * @brief Gets the bits set in the event group.
+ *
+ * @param event Pointer for the event group
+ * @param bits Pointer that receives the bits
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int event_get(event_t *event, unsigned int *bits);
+
+/**
+ * @brief Destroy the event group
+ *
+ * Destroy the event group, and wake up all the tasks waiting for it. This tasks
+ * return with an error code.
+ *
+ * @param event Pointer for the event group
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int event_destroy(event_t *event);
+
+//=============================================================================
+// Select Management
+//=============================================================================
+
+/**
+ * @brief Waits until one of the objects in the set is ready.
+ *
+ * Suspends the task on every semaphore and message queue of the set at once,
+ * and returns as soon as one of them becomes ready. A semaphore is ready when
+ * it has a unit available that is not reserved for the tasks waiting on it, as
+ * sem_down would take, and a message queue when it has a message to be
+ * received. The ready field of each entry is filled with 1 if the object is
+ * ready, -1 if it was destroyed, and 0 otherwise.
+ *
+ * The objects are not consumed, so the task still needs to call sem_down or
+ * mqueue_recv, which may suspend it if another task got there first.
+ *
+ * @param set Array with the objects to be watched
+ * @param num Number of entries in the array
+ *
+ * @return The number of entries ready or destroyed, and -1 on error.
+ */
+int ppos_select(select_t *set, int num);
+
 #endif // PPOS_H
\ No newline at end of file
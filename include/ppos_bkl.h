@@ -11,8 +11,10 @@
 
 /**
  * @brief Initializes the Big Kernel Lock
+ *
+ * @param release Function called whenever the lock is released, or NULL
  */
-void bkl_init();
+void bkl_init(void (*release)(void));
 
 /**
  * @brief Locks the Big Kernel Lock
@@ -27,3 +29,15 @@ int bkl_lock();
  * @return 0 if could be unlocked, and 1 otherwise.
  */
 int bkl_unlock();
+
+/**
+ * @brief Checks the Big Kernel Lock without locking it
+ *
+ * @return 1 if the lock is held, and 0 otherwise.
+ */
+int bkl_held();
+
+/**
+ * @brief Spins until the Big Kernel Lock could be locked
+ */
+#define bkl_spinlock() while (bkl_lock())
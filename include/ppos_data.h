@@ -24,6 +24,9 @@
 
 #define TASK_QUANTUM (20) // In milliseconds
 
+// Entries of the quantum table, one for each priority
+#define QUANTUM_LEVELS (TASK_MAX_PRIO - TASK_MIN_PRIO + 1)
+
 // Reserved IDs for special Tasks
 #define MAIN_TASK (0)
 #define DISPATCHER_TASK (1)
@@ -40,6 +43,56 @@ typedef enum task_type {
   SYSTEM,
 } task_type;
 
+// Time spent by a task in each state, in nanoseconds
+typedef struct task_times_t {
+  // Executing on the processor
+  unsigned long long run;
+
+  // Waiting in the ready queue
+  unsigned long long ready;
+
+  // Suspended or sleeping
+  unsigned long long blocked;
+} task_times_t;
+
+// Counters of a periodic task of the real-time class
+typedef struct task_rt_stats_t {
+  // Jobs completed
+  unsigned int jobs;
+
+  // Jobs that did not complete before their deadline
+  unsigned int misses;
+
+  // Times the task was suspended for consuming all the budget of a job
+  unsigned int throttles;
+} task_rt_stats_t;
+
+// Periodic parameters of a task of the real-time class, in milliseconds
+typedef struct task_rt_t {
+  // Interval between the releases of the jobs, 0 for a time-sharing task
+  unsigned int period;
+
+  // Deadline of each job, relative to its release
+  unsigned int deadline;
+
+  // Processor time that each job may consume
+  unsigned int budget;
+
+  // Release of the current job
+  unsigned int release;
+
+  // Absolute deadline of the current job
+  unsigned int abs_deadline;
+
+  // Processor time already consumed by the current job
+  unsigned int used;
+
+  // If the miss of the current job was already counted
+  int missed;
+
+  task_rt_stats_t stats;
+} task_rt_t;
+
 // Structure for the TCB (Task Control Block)
 typedef struct task_t {
   // Used in the queue_t
@@ -57,7 +110,11 @@ typedef struct task_t {
   // The stack used by the context
   char *stack;
 
-  // The start priority of the task (default is 0)
+  // The priority set to the task (default is 0)
+  int static_priority;
+
+  // The start priority of the task. The same as the static priority, unless
+  // the task inherited a higher one from a task waiting for its mutexes
   int initial_priority;
 
   // The real priority of the task.
@@ -69,15 +126,24 @@ typedef struct task_t {
   // Total quantum that the task has to execute
   unsigned int quantum;
 
-  // Total time of execution on CPU
-  unsigned int total_time;
+  // Quantum set for this task, or 0 to use the one of its priority
+  unsigned int fixed_quantum;
 
-  // Current system time of the task execution
-  unsigned int current_time;
+  // Time spent in each state, charged whenever the task changes of state
+  task_times_t times;
+
+  // System time of the last change of state, in nanoseconds
+  unsigned long long state_time;
 
   // Mark the time that the task is going to sleep
   unsigned int sleep_time;
 
+  // Earliest time the sleeping task may be awakened, up to the sleep time
+  unsigned int sleep_early;
+
+  // Delay that the wakeups of the task accept, to be awakened with others
+  unsigned int timer_slack;
+
   // Number of times the task was dispatched
   unsigned int num_calls;
 
@@ -90,18 +156,211 @@ typedef struct task_t {
   // Return value of the task waited
   int waiting_result;
 
+  // List of mutexes held by this task
+  struct mutex_t *held_mutexes;
+
+  // Mutex that this task is waiting for
+  struct mutex_t *waiting_mutex;
+
+  // Groups of tasks waiting for this one among others
+  struct wait_entry_t *wait_entries;
+
+  // Reservation of processor that limits this task, shared with others
+  struct cpu_budget_t *cpu_budget;
+
+  // Number of units the task is waiting for in a semaphore
+  int sem_units;
+
+  // Level of the task in the wait queue ordered by priority where it waits
+  int wait_level;
+
+  // Wait queue ordered by priority where the task waits, and its levels, to
+  // move the task when its priority changes
+  struct task_t **wait_queue;
+  struct wait_order_t *wait_order;
+
+  // Bits of an event group the task is waiting for, and once awakened the bits
+  // that satisfied it
+  unsigned int event_bits;
+
+  // How the task waits for the bits of the event group (EVENT_* flags)
+  int event_flags;
+
+  // Whether the task waiting for a condition variable was signaled, instead of
+  // awakened by its destruction
+  int cond_signaled;
+
+  // Parameters of the real-time class, only used by periodic tasks
+  task_rt_t rt;
+
+  // Nesting of the regions where the task can not be preempted
+  int preempt_count;
+
 } task_t;
 
+//=============================================================================
+// Wait Group Structure
+//=============================================================================
+
+// Structure for a task waiting for a set of tasks
+typedef struct wait_group_t {
+  // Queue with the waiting task
+  task_t *queue;
+
+  // Number of tasks that still need to finish to wake the waiting task
+  int remaining;
+
+  // Index of the first task of the set to finish, or -1
+  int first;
+} wait_group_t;
+
+// Structure linking a task being waited to the group waiting for it
+typedef struct wait_entry_t {
+  // Group waiting for the task
+  wait_group_t *group;
+
+  // Index of the task in the set
+  int index;
+
+  // Next entry of the same task
+  struct wait_entry_t *next;
+} wait_entry_t;
+
+//=============================================================================
+// Wait Order Structure
+//=============================================================================
+
+// Number of levels of a wait queue ordered by priority, one for each priority
+#define WAIT_LEVELS (TASK_MAX_PRIO - TASK_MIN_PRIO + 1)
+
+typedef enum wait_policy {
+  WAIT_FIFO, // Tasks are served in the order they arrived
+  WAIT_PRIO, // Tasks are served by priority, and in arrival order inside it
+} wait_policy;
+
+// Structure keeping a wait queue ordered by priority
+typedef struct wait_order_t {
+  // Last task waiting in each level (NULL if there is none)
+  task_t *tails[WAIT_LEVELS];
+
+  // Bitmap of the levels with waiting tasks
+  unsigned long long map;
+} wait_order_t;
+
+//=============================================================================
+// Adaptive Locking
+//=============================================================================
+
+// Default number of times a task yields waiting for a lock before suspending
+#define SPIN_LIMIT (4)
+
+// Locks held longer than this on average are not worth waiting by yielding
+#define SPIN_MAX_HOLD (200000) // In nanoseconds
+
+// Weight of the last sample in the average hold time (1/SPIN_HOLD_WEIGHT)
+#define SPIN_HOLD_WEIGHT (8)
+
+// Only one in this many acquisitions has its hold time measured
+#define SPIN_HOLD_SAMPLE (16)
+
 //=============================================================================
 // Mutex Structure
 //=============================================================================
 
 // Structure for the Mutex
 typedef struct mutex_t {
-  // Mutual exclusion
+  // Mutual exclusion (-1 if the mutex was destroyed)
   int lock;
+
+  // Task holding the mutex
+  task_t *owner;
+
+  // Queue of waiting tasks
+  task_t *queue;
+
+  // Levels of the queue when it is ordered by priority (NULL if it is FIFO)
+  wait_order_t *order;
+
+  // Next mutex held by the same owner
+  struct mutex_t *next_held;
+
+  // Number of times the mutex was acquired
+  unsigned int num_acquires;
+
+  // Max number of times a task yields waiting for the mutex before suspending
+  int spin_limit;
+
+  // Average time that the mutex is held, in nanoseconds
+  unsigned long long hold_avg;
+
+  // System time when the mutex was acquired, in nanoseconds (0 if the hold
+  // time is not being measured)
+  unsigned long long hold_start;
+
+  // Number of times a task yielded waiting for the mutex
+  unsigned int num_spins;
+
+  // Number of times the mutex was acquired after yielding
+  unsigned int num_spin_acquires;
+
+  // Number of times a task had to be suspended waiting for the mutex
+  unsigned int num_suspends;
+
+  // Flag to indicate that the mutex needs to be handed to a waiting task
+  int pending;
+
+  // Next mutex that needs to be handed to a waiting task
+  struct mutex_t *next_pending;
 } mutex_t;
 
+//=============================================================================
+// Condition Variable Structure
+//=============================================================================
+
+typedef enum cond_state {
+  COND_INITALIZED,
+  COND_FINISHED,
+} cond_state;
+
+// Structure for the Condition Variable
+typedef struct cond_t {
+  // Queue of waiting tasks
+  task_t *queue;
+
+  // Mutex released by the waiting tasks
+  mutex_t *mutex;
+
+  // Flag to verify the state of the condition variable
+  cond_state state;
+} cond_t;
+
+//=============================================================================
+// Select Structure
+//=============================================================================
+
+typedef enum select_type {
+  SELECT_SEM,
+  SELECT_MQUEUE,
+} select_type;
+
+// Structure for an object watched by ppos_select
+typedef struct select_t {
+  // Type of the object being watched
+  select_type type;
+
+  // Pointer for the semaphore_t or mqueue_t being watched
+  void *object;
+
+  // 1 if the object is ready, -1 if it was destroyed, and 0 otherwise
+  int ready;
+
+  // Queue where the selecting task is suspended
+  task_t **waiting;
+
+  // Next entry watching the same semaphore
+  struct select_t *next_watch;
+} select_t;
+
 //=============================================================================
 // Semaphore Structure
 //=============================================================================
@@ -122,8 +381,80 @@ typedef struct semaphore_t {
 
   // Queue of waiting tasks
   task_t *queue;
+
+  // Levels of the queue when it is ordered by priority (NULL if it is FIFO)
+  wait_order_t *order;
+
+  // Number of units acquired through sem_down
+  unsigned int num_acquires;
+
+  // Number of times a task had to be suspended waiting for a unit
+  unsigned int num_suspends;
+
+  // Number of times a waiting task was awakened
+  unsigned int num_wakeups;
+
+  // Max number of times a task yields waiting for a unit before suspending
+  int spin_limit;
+
+  // Average time that a unit is held, in nanoseconds
+  unsigned long long hold_avg;
+
+  // System time when the last unit was acquired, in nanoseconds (0 if the hold
+  // time is not being measured)
+  unsigned long long hold_start;
+
+  // Number of times a task yielded waiting for a unit
+  unsigned int num_spins;
+
+  // Number of units acquired after yielding
+  unsigned int num_spin_acquires;
+
+  // Flag to indicate that units need to be handed to the waiting tasks
+  int pending;
+
+  // Next semaphore that needs to hand units to the waiting tasks
+  struct semaphore_t *next_pending;
+
+  // Entries of ppos_select waiting for a unit of this semaphore
+  select_t *watchers;
 } semaphore_t;
 
+//=============================================================================
+// Reader-Writer Lock Structure
+//=============================================================================
+
+typedef enum rwlock_state {
+  RW_INITALIZED,
+  RW_FINISHED,
+} rwlock_state;
+
+typedef enum rwlock_pref {
+  RW_PREFER_READERS,
+  RW_PREFER_WRITERS,
+} rwlock_pref;
+
+// Structure for the Reader-Writer Lock
+typedef struct rwlock_t {
+  // Number of readers holding the lock
+  int readers;
+
+  // Flag to indicate that a writer holds the lock
+  int writer;
+
+  // Who gets the lock first when both readers and writers are waiting
+  rwlock_pref pref;
+
+  // Flag to verify the state of the lock
+  rwlock_state state;
+
+  // Queue of waiting readers
+  task_t *readers_queue;
+
+  // Queue of waiting writers
+  task_t *writers_queue;
+} rwlock_t;
+
 //=============================================================================
 // Barrier Structure
 //=============================================================================
@@ -145,6 +476,42 @@ typedef struct barrier_t {
   task_t *queue;
 } barrier_t;
 
+// Number of children of each node in the tree barrier
+#define TBARRIER_RADIX (4)
+
+// Structure for a node of the tree barrier
+typedef struct tbarrier_node_t {
+  // Number of children that still need to arrive
+  int count;
+
+  // Number of children of this node
+  int num;
+
+  // Flipped every time the node is released
+  int sense;
+
+  // Node that receives the arrival of this one, NULL in the root
+  struct tbarrier_node_t *parent;
+
+  // Queue of tasks waiting the release of this node
+  task_t *queue;
+} tbarrier_node_t;
+
+// Structure for the Tree Barrier
+typedef struct tbarrier_t {
+  // Number of tasks that needs to wait
+  int num_tasks;
+
+  // Nodes of the tree, starting by the leaves
+  tbarrier_node_t *nodes;
+
+  // Number of nodes in the tree
+  int num_nodes;
+
+  // Flag to verify the state of the barrier
+  barrier_state state;
+} tbarrier_t;
+
 //=============================================================================
 // Message Queue Structure
 //=============================================================================
@@ -154,13 +521,31 @@ typedef enum mqueue_state {
   MQE_FINISHED,
 } mqueue_state;
 
+// Max number of priorities of a message queue
+#define MQUEUE_MAX_PRIOS (32)
+
 // Structure for the Message Queue
 typedef struct mqueue_t {
   // Array of messages
   void *msgs;
 
-  // Current index of the array
-  int index;
+  // Next slot of each slot in its list, or -1 at the end of the list
+  int *links;
+
+  // First slot of the messages of each priority, or -1 if there is none
+  int *heads;
+
+  // Last slot of the messages of each priority
+  int *tails;
+
+  // Bit i is set if there are messages with priority i
+  unsigned int prio_map;
+
+  // Number of priorities, 0 is the highest one
+  int num_prios;
+
+  // First slot of the list of free slots
+  int free_slot;
 
   // Max number of messagens
   int max_msgs;
@@ -181,4 +566,220 @@ typedef struct mqueue_t {
   semaphore_t sem_cons;
 } mqueue_t;
 
+//=============================================================================
+// Channel Structure
+//=============================================================================
+
+typedef enum channel_state {
+  CHAN_INITALIZED,
+  CHAN_FINISHED,
+} channel_state;
+
+typedef enum channel_mode {
+  // Records can be split between the end and the beginning of the buffer
+  CHAN_SPLIT,
+  // Records are always stored contiguously, skipping the end of the buffer
+  CHAN_NOSPLIT,
+} channel_mode;
+
+// Structure for the Channel, a ring of records prefixed by their length
+typedef struct channel_t {
+  // Ring buffer with the records
+  char *buffer;
+
+  // Size of the buffer in bytes
+  int size;
+
+  // Offset of the next record to be received
+  int head;
+
+  // Offset where the next record is going to be sent
+  int tail;
+
+  // Number of bytes in use, including headers and skipped bytes
+  int used;
+
+  // Number of records in the channel
+  int num_msgs;
+
+  // How records are placed at the end of the buffer
+  channel_mode mode;
+
+  // Flag to verify the state of the channel
+  channel_state state;
+
+  // Queue of tasks waiting for space to send
+  task_t *senders;
+
+  // Queue of tasks waiting for a record to receive
+  task_t *receivers;
+} channel_t;
+
+//=============================================================================
+// Broadcast Structure
+//=============================================================================
+
+typedef enum bcast_state {
+  BCAST_INITALIZED,
+  BCAST_FINISHED,
+} bcast_state;
+
+typedef enum bcast_policy {
+  // The sender waits for the slowest subscriber
+  BCAST_BLOCK,
+  // The oldest messages are overwritten, and lagging subscribers lose them
+  BCAST_DROP,
+} bcast_policy;
+
+// Structure for a subscriber of the broadcast ring
+typedef struct bcast_sub_t {
+  // Ring that the subscriber reads
+  struct bcast_t *bcast;
+
+  // Sequence number of the next message to be received
+  unsigned long seq;
+
+  // Number of messages lost because the subscriber lagged behind
+  unsigned long num_drops;
+
+  // Next subscriber of the same ring
+  struct bcast_sub_t *next;
+} bcast_sub_t;
+
+// Structure for the Broadcast ring
+typedef struct bcast_t {
+  // Array of messages
+  void *msgs;
+
+  // Max number of messages
+  int max_msgs;
+
+  // The size of the stored elements
+  size_t msg_size;
+
+  // Sequence number of the next message to be sent
+  unsigned long seq;
+
+  // What happens when a subscriber lags a whole ring behind
+  bcast_policy policy;
+
+  // Flag to verify the state of the ring
+  bcast_state state;
+
+  // List of subscribers
+  bcast_sub_t *subs;
+
+  // Queue of tasks waiting for the slowest subscriber
+  task_t *senders;
+
+  // Queue of subscribers waiting for a new message
+  task_t *receivers;
+} bcast_t;
+
+//=============================================================================
+// Future Structure
+//=============================================================================
+
+typedef enum future_state {
+  FUTURE_PENDING,
+  FUTURE_DONE,
+  FUTURE_FINISHED,
+} future_state;
+
+// Structure for the Future, a value that is completed once by some task
+typedef struct future_t {
+  // Value of the future, once completed
+  void *value;
+
+  // Flag to verify the state of the future
+  future_state state;
+
+  // Queue of tasks waiting for the value
+  task_t *queue;
+} future_t;
+
+//=============================================================================
+// Event Group Structure
+//=============================================================================
+
+typedef enum event_state {
+  EVENT_INITALIZED,
+  EVENT_FINISHED,
+} event_state;
+
+// Flags of event_wait, the task waits for any of the bits by default
+#define EVENT_ALL (1 << 0)   // Waits for all the bits
+#define EVENT_CLEAR (1 << 1) // Clears the bits waited once satisfied
+
+// Structure for the Event Group, a set of bits that tasks can wait for
+typedef struct event_t {
+  // Bits that are set
+  unsigned int bits;
+
+  // Flag to verify the state of the event group
+  event_state state;
+
+  // Queue of tasks waiting for bits
+  task_t *queue;
+
+  // Number of times a waiting task was awakened
+  unsigned int num_wakeups;
+} event_t;
+
+//=============================================================================
+// Software Timer Structure
+//=============================================================================
+
+// Structure for a software timer, executed by the dispatcher once it expires
+typedef struct ppos_timer_t {
+  // System time when the timer expires, in milliseconds
+  unsigned int expire;
+
+  // Interval between the expirations, 0 for a one-shot timer
+  unsigned int period;
+
+  // Order in which the timer was armed, between timers expiring together
+  unsigned int seq;
+
+  // Position of the timer in the timer heap, only valid while armed
+  int index;
+
+  // Function executed once the timer expires
+  void (*callback)(void *arg);
+
+  // Argument passed to the function
+  void *arg;
+
+  // Number of times the function was executed
+  unsigned int num_fired;
+} ppos_timer_t;
+
+//=============================================================================
+// CPU Budget Structure
+//=============================================================================
+
+// Structure for a reservation of processor, shared by a group of tasks
+typedef struct cpu_budget_t {
+  // Processor time of the group in each period, in milliseconds
+  unsigned int runtime;
+
+  // Interval between the replenishments, in milliseconds
+  unsigned int period;
+
+  // Processor time used by the group in the current period, in milliseconds
+  unsigned int used;
+
+  // System time of the next replenishment, in milliseconds
+  unsigned int replenish;
+
+  // Number of tasks in the group
+  int num_tasks;
+
+  // Number of periods where the group used all of its processor time
+  unsigned int num_depleted;
+
+  // Number of times a task of the group was parked until the replenishment
+  unsigned int num_throttles;
+} cpu_budget_t;
+
 #endif // PP_DATA_H
@@ -0,0 +1,96 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppos_ipc.h
+ * Description: Interface between the dispatcher and the Inter Process
+ * Comunication of the PingPong OS
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#ifndef PPOS_IPC_H
+#define PPOS_IPC_H
+
+#include "ppos_data.h"
+
+/**
+ * @brief Returns the task that is executing.
+ *
+ * Used by the IPC to record what the task is waiting for before suspending it.
+ *
+ * @return Pointer for the executing task.
+ */
+task_t *task_self();
+
+/**
+ * @brief Inserts a task in a wait queue.
+ *
+ * With an order the task goes after every task of the same or higher priority
+ * in the queue, in constant time. Without one it goes to the end of the queue.
+ *
+ * @param queue Pointer for the wait queue
+ * @param order Levels of the queue, or NULL if the queue is FIFO
+ * @param task Pointer for the task
+ *
+ * @return 0 on success, and a negative value otherwise.
+ */
+int wait_order_insert(task_t **queue, wait_order_t *order, task_t *task);
+
+/**
+ * @brief Removes a task from a wait queue, keeping its levels.
+ *
+ * @param queue Pointer for the wait queue
+ * @param order Levels of the queue, or NULL if the queue is FIFO
+ * @param task Pointer for the task
+ *
+ * @return 0 on success, and a negative value otherwise.
+ */
+int wait_order_remove(task_t **queue, wait_order_t *order, task_t *task);
+
+/**
+ * @brief Changes the policy of a wait queue.
+ *
+ * The policy can only be changed while there is no task waiting.
+ *
+ * @param order Pointer for the levels of the queue (NULL if the queue is FIFO)
+ * @param queue The wait queue
+ * @param policy WAIT_FIFO or WAIT_PRIO
+ *
+ * @return 0 on success, and -1 otherwise.
+ */
+int wait_order_set(wait_order_t **order, const task_t *queue,
+                   wait_policy policy);
+
+/**
+ * @brief Suspends the executing task in a wait queue.
+ *
+ * Works like task_suspend, but inserting the task with wait_order_insert.
+ *
+ * @param queue Pointer for the wait queue
+ * @param order Levels of the queue, or NULL if the queue is FIFO
+ */
+void task_suspend_order(task_t **queue, wait_order_t *order);
+
+/**
+ * @brief Awakes a task waiting in a wait queue.
+ *
+ * Works like task_awake, but removing the task with wait_order_remove.
+ *
+ * @param task Pointer for the task
+ * @param queue Pointer for the wait queue
+ * @param order Levels of the queue, or NULL if the queue is FIFO
+ */
+void task_awake_order(task_t *task, task_t **queue, wait_order_t *order);
+
+/**
+ * @brief Hands the released units to the tasks waiting for them.
+ *
+ * The units released by sem_up while there are tasks waiting are only handed
+ * when the releasing task leaves the processor, as the waiting tasks could not
+ * execute before that. This function is called by the dispatcher every time
+ * the executing task leaves the processor.
+ */
+void sem_handoff();
+
+#endif // PPOS_IPC_H
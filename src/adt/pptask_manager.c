@@ -111,6 +111,29 @@ int task_manager_insert(TaskManager *manager, task_t *task) {
   return 0;
 }
 
+int task_manager_splice(TaskManager *manager, task_t **queue) {
+  if (manager == NULL) {
+    log_error("received a NULL manager");
+    return -1;
+  }
+
+  if (queue == NULL) {
+    log_error("received a NULL queue");
+    return -1;
+  }
+
+  log_debug("splicing tasks in queue %s", manager->name);
+  int count = queue_merge_inorder((queue_t **)&(manager->taskQueue),
+                                  (queue_t **)queue, manager->comp_func);
+  if (count < 0) {
+    log_error("could not splice tasks in queue %s", manager->name);
+    return -1;
+  }
+
+  manager->count += count;
+  return count;
+}
+
 int task_manager_remove(TaskManager *manager, task_t *task) {
   if (manager == NULL) {
     log_error("received a NULL manager");
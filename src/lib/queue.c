@@ -2,6 +2,55 @@
 
 #include "stdio.h"
 
+//------------------------------------------------------------------------------
+// Private Functions
+//------------------------------------------------------------------------------
+
+// Merges two lists terminated by NULL, keeping the elements of the first list
+// before the equal ones of the second, and returns the head of the result
+static queue_t *merge_list(queue_t *first, queue_t *second,
+                           int (*compare)(const void *ptr1, const void *ptr2)) {
+  queue_t head = { NULL, NULL };
+  queue_t *tail = &head;
+
+  while (first && second) {
+    if (compare(second, first) < 0) {
+      tail->next = second;
+      second = second->next;
+    } else {
+      tail->next = first;
+      first = first->next;
+    }
+    tail = tail->next;
+  }
+
+  tail->next = first ? first : second;
+  return head.next;
+}
+
+// Sorts a list terminated by NULL with a stable merge sort, and returns the
+// head of the sorted list
+static queue_t *sort_list(queue_t *list,
+                          int (*compare)(const void *ptr1, const void *ptr2)) {
+  if (list == NULL || list->next == NULL) {
+    return list;
+  }
+
+  // Splits the list in the middle
+  queue_t *slow = list;
+  queue_t *fast = list->next;
+  while (fast && fast->next) {
+    slow = slow->next;
+    fast = fast->next->next;
+  }
+
+  queue_t *second = slow->next;
+  slow->next = NULL;
+
+  return merge_list(sort_list(list, compare), sort_list(second, compare),
+                    compare);
+}
+
 //------------------------------------------------------------------------------
 // Public Functions
 //------------------------------------------------------------------------------
@@ -128,6 +177,70 @@ int queue_insert_inorder(queue_t **queue, queue_t *elem,
   return 0;
 }
 
+int queue_merge_inorder(queue_t **queue, queue_t **other,
+                        int (*compare)(const void *ptr1, const void *ptr2)) {
+  if (queue == NULL || other == NULL) {
+    return Q_ERR_NULL;
+  }
+
+  if (*other == NULL) {
+    return 0;
+  }
+
+  // Detaches both queues as lists terminated by NULL
+  queue_t *incoming = *other;
+  incoming->prev->next = NULL;
+  *other = NULL;
+
+  queue_t *current = *queue;
+  if (current) {
+    current->prev->next = NULL;
+  }
+
+  // The new elements are placed before the first element of the queue that
+  // they should come before, and after the equal ones
+  incoming = sort_list(incoming, compare);
+  queue_t head = { NULL, NULL };
+  queue_t *tail = &head;
+  int count = 0;
+
+  while (incoming && current) {
+    if (compare(incoming, current) < 0) {
+      tail->next = incoming;
+      incoming = incoming->next;
+      count++;
+    } else {
+      tail->next = current;
+      current = current->next;
+    }
+    tail->next->prev = tail;
+    tail = tail->next;
+  }
+
+  while (incoming) {
+    tail->next = incoming;
+    incoming->prev = tail;
+    tail = incoming;
+    incoming = incoming->next;
+    count++;
+  }
+
+  if (current) {
+    tail->next = current;
+    current->prev = tail;
+    while (tail->next) {
+      tail = tail->next;
+    }
+  }
+
+  // Closes the circle again
+  *queue = head.next;
+  (*queue)->prev = tail;
+  tail->next = *queue;
+
+  return count;
+}
+
 int queue_remove(queue_t **queue, queue_t *elem) {
   if (queue == NULL) {
     return Q_ERR_NULL;
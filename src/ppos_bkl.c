@@ -9,12 +9,35 @@
  * License: BSD 2
  */
 
-#include "ppos.h"
+#include "ppos_bkl.h"
 
-static mutex_t bigKernelLock;
+#include <stddef.h>
 
-void bkl_init() { mutex_init(&bigKernelLock); }
+// The mutexes can suspend the caller, so the lock is kept as a simple flag
+static int bigKernelLock = 0;
 
-int bkl_lock() { return mutex_lock(&bigKernelLock); }
+// Called once the lock is released
+static void (*releaseFunc)(void) = NULL;
 
-int bkl_unlock() { return mutex_unlock(&bigKernelLock); }
\ No newline at end of file
+void bkl_init(void (*release)(void)) {
+  bigKernelLock = 0;
+  releaseFunc = release;
+}
+
+int bkl_lock() {
+  int lock = bigKernelLock;
+  bigKernelLock = 1;
+  return lock;
+}
+
+int bkl_unlock() {
+  int lock = bigKernelLock;
+  bigKernelLock = 0;
+  if (lock && releaseFunc) {
+    releaseFunc();
+  }
+
+  return lock;
+}
+
+int bkl_held() { return bigKernelLock; }
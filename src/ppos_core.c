@@ -14,6 +14,7 @@
 #include "ppos.h"
 #include "ppos_bkl.h"
 #include "ppos_data.h"
+#include "ppos_ipc.h"
 
 #include <assert.h>
 #include <signal.h>
@@ -21,50 +22,484 @@
 #include <stdlib.h>
 #include <sys/time.h>
 #include <sys/ucontext.h>
+#include <time.h>
 #include <ucontext.h>
 
 // Task Global structures
 static TaskManager *readyQueue = NULL;
 static TaskManager *sleepQueue = NULL;
+// Sleep time of the first task in the sleep queue, checked by the timer
+static unsigned int nextWakeup = 0;
+// Task awakened with the first one that is the most likely to preempt
+static task_t *nextWakeupTask = NULL;
 static task_t *executingTask = NULL;
 static task_t *dispatcherTask = NULL;
+// Task that called ppos_init, whose exit code is the one of the process
+static task_t *mainTask = NULL;
 static int numSuspedingTasks = 0;
 
+// Mutexes unlocked while there were tasks waiting for them
+static mutex_t *pendingMutexes = NULL;
+
+// A tick wanted to preempt a task that could not be preempted
+static int reschedPending = 0;
+
+// Priority gap that an awakened task needs to preempt the executing one
+static int wakeupGap = 0;
+
+// Quantum given to the tasks of each priority, from the lowest value
+static unsigned int quantumTable[QUANTUM_LEVELS];
+
+// Software timers armed, kept in a binary heap ordered by expiration
+static ppos_timer_t **timerHeap = NULL;
+static int timerCount = 0;
+static int timerCapacity = 0;
+// Expiration of the first timer in the heap, checked by the timer
+static unsigned int timerNext = 0;
+
 // Timer Global structur
 static unsigned int totalSysTime = 0;
+static struct timespec startSysTime;
+// Time of the last tick in nanoseconds, the ticks may lag behind the clock
+static unsigned long long lastTickTime = 0;
 
 #define TIMER 1000 // 1 ms in microseconds
+#define TICK_NS (TIMER * 1000ULL)
+
+//=============================================================================
+// Real-Time Private Functions
+//=============================================================================
+
+/**
+ * @brief Checks if a time has already passed.
+ *
+ * @param time System time, in milliseconds
+ *
+ * @return 1 if the time is before the current system time, or 0 otherwise.
+ */
+static int __time_passed(unsigned int time) {
+  return (int)(totalSysTime - time) > 0;
+}
+
+/**
+ * @brief Counts the miss of the current job of a periodic task.
+ *
+ * Each job is counted only once, even if its deadline is checked again.
+ *
+ * @param task Pointer for the periodic task
+ */
+static void __rt_check_miss(task_t *task) {
+  if (!task->rt.missed && __time_passed(task->rt.abs_deadline)) {
+    task->rt.missed = 1;
+    task->rt.stats.misses++;
+    log_debug("task(%d) missed the deadline %u", task->tid,
+              task->rt.abs_deadline);
+  }
+}
+
+/**
+ * @brief Moves a periodic task to its next job.
+ *
+ * The releases keep the phase of the period, so a job that ended late has the
+ * next one already released.
+ *
+ * @param task Pointer for the periodic task
+ */
+static void __rt_next_job(task_t *task) {
+  task->rt.release += task->rt.period;
+  task->rt.abs_deadline = task->rt.release + task->rt.deadline;
+  task->rt.used = 0;
+  task->rt.missed = 0;
+}
+
+/**
+ * @brief Charges a tick of processor to the job of the executing periodic task.
+ *
+ * @param task Pointer for the periodic task
+ *
+ * @return 1 if the job consumed all of its budget, or 0 otherwise.
+ */
+static int __rt_charge(task_t *task) {
+  task->rt.used++;
+  __rt_check_miss(task);
+  return task->rt.used >= task->rt.budget;
+}
+
+//=============================================================================
+// CPU Budget Private Functions
+//=============================================================================
+
+/**
+ * @brief Replenishes the processor time of a group, if the period is over.
+ *
+ * The replenishments keep the phase of the period, and the periods where the
+ * group did not execute are skipped.
+ *
+ * @param budget Pointer for the budget of the group
+ */
+static void __budget_refill(cpu_budget_t *budget) {
+  if ((int)(totalSysTime - budget->replenish) < 0) {
+    return;
+  }
+
+  unsigned int late = totalSysTime - budget->replenish;
+  budget->replenish += (late / budget->period + 1) * budget->period;
+  budget->used = 0;
+}
+
+/**
+ * @brief Checks if a group used all of its processor time in the period.
+ *
+ * @param budget Pointer for the budget of the group
+ *
+ * @return 1 if the group has to wait for the replenishment, or 0 otherwise.
+ */
+static int __budget_depleted(cpu_budget_t *budget) {
+  __budget_refill(budget);
+  return budget->used >= budget->runtime;
+}
+
+/**
+ * @brief Charges a tick of processor to the group of the executing task.
+ *
+ * @param budget Pointer for the budget of the group
+ *
+ * @return 1 if the group used all of its processor time, or 0 otherwise.
+ */
+static int __budget_charge(cpu_budget_t *budget) {
+  __budget_refill(budget);
+  budget->used++;
+  if (budget->used == budget->runtime) {
+    budget->num_depleted++;
+  }
+
+  return budget->used >= budget->runtime;
+}
+
+//=============================================================================
+// Software Timer Private Functions
+//=============================================================================
+
+#define TIMER_HEAP_SIZE (16)
+
+/**
+ * @brief Compare the expiration of two software timers
+ *
+ * @param timer1 Pointer for the first timer
+ * @param timer2 Pointer for the second timer
+ *
+ * @return 0< if the first timer expires before, and 0> otherwise. Timers
+ * expiring together are ordered by the time they were armed.
+ */
+static int __timer_comp(const ppos_timer_t *timer1,
+                        const ppos_timer_t *timer2) {
+  int diff = (int)(timer1->expire - timer2->expire);
+  if (diff) {
+    return diff;
+  }
+
+  return (int)(timer1->seq - timer2->seq);
+}
+
+/**
+ * @brief Places a timer in a position of the heap.
+ *
+ * @param timer Pointer for the timer
+ * @param index Position of the heap
+ */
+static void __timer_place(ppos_timer_t *timer, int index) {
+  timerHeap[index] = timer;
+  timer->index = index;
+  if (index == 0) {
+    timerNext = timer->expire;
+  }
+}
+
+/**
+ * @brief Moves a timer up the heap, until its parent expires before it.
+ *
+ * @param index Position of the timer in the heap
+ */
+static void __timer_sift_up(int index) {
+  ppos_timer_t *timer = timerHeap[index];
+  while (index > 0) {
+    int parent = (index - 1) / 2;
+    if (__timer_comp(timerHeap[parent], timer) <= 0) {
+      break;
+    }
+
+    __timer_place(timerHeap[parent], index);
+    index = parent;
+  }
+
+  __timer_place(timer, index);
+}
+
+/**
+ * @brief Moves a timer down the heap, until its children expire after it.
+ *
+ * @param index Position of the timer in the heap
+ */
+static void __timer_sift_down(int index) {
+  ppos_timer_t *timer = timerHeap[index];
+  while (2 * index + 1 < timerCount) {
+    int child = 2 * index + 1;
+    if (child + 1 < timerCount
+        && __timer_comp(timerHeap[child + 1], timerHeap[child]) < 0) {
+      child++;
+    }
+
+    if (__timer_comp(timer, timerHeap[child]) <= 0) {
+      break;
+    }
+
+    __timer_place(timerHeap[child], index);
+    index = child;
+  }
+
+  __timer_place(timer, index);
+}
+
+/**
+ * @brief Checks if a timer is in the heap.
+ *
+ * @param timer Pointer for the timer
+ *
+ * @return 1 if the timer is armed, or 0 otherwise.
+ */
+static int __timer_armed(const ppos_timer_t *timer) {
+  return timer->index >= 0 && timer->index < timerCount
+         && timerHeap[timer->index] == timer;
+}
+
+/**
+ * @brief Inserts a timer in the heap.
+ *
+ * @param timer Pointer for the timer
+ *
+ * @return 0 on success, and -1 if the heap could not grow.
+ */
+static int __timer_insert(ppos_timer_t *timer) {
+  static unsigned int seq = 0;
+
+  if (timerCount == timerCapacity) {
+    int capacity = timerCapacity ? 2 * timerCapacity : TIMER_HEAP_SIZE;
+    ppos_timer_t **heap =
+      realloc(timerHeap, (size_t)capacity * sizeof(ppos_timer_t *));
+    if (heap == NULL) {
+      log_debug("could not grow the timer heap");
+      return -1;
+    }
+
+    timerHeap = heap;
+    timerCapacity = capacity;
+  }
+
+  timer->seq = seq++;
+  timerCount++;
+  __timer_place(timer, timerCount - 1);
+  __timer_sift_up(timerCount - 1);
+  return 0;
+}
+
+/**
+ * @brief Removes a timer of the heap.
+ *
+ * @param timer Pointer for the timer, that must be armed
+ */
+static void __timer_remove(ppos_timer_t *timer) {
+  int index = timer->index;
+  timer->index = -1;
+  timerCount--;
+
+  // The last timer takes the place left, and goes up or down from there
+  if (index != timerCount) {
+    ppos_timer_t *last = timerHeap[timerCount];
+    __timer_place(last, index);
+    __timer_sift_down(index);
+    __timer_sift_up(last->index);
+  }
+}
+
+/**
+ * @brief Checks if the first timer of the heap has expired.
+ *
+ * @return 1 if there is a timer to fire, or 0 otherwise.
+ */
+static int __timer_due() {
+  return timerCount && (int)(totalSysTime - timerNext) >= 0;
+}
+
+/**
+ * @brief Executes the callbacks of the timers that expired.
+ *
+ * Called by the dispatcher holding the kernel lock, that is released while
+ * each callback executes, so it can use the functions of the OS. A periodic
+ * timer is armed again before its callback, keeping its phase, so the
+ * callback can cancel it.
+ */
+static void __timer_fire() {
+  while (__timer_due()) {
+    ppos_timer_t *timer = timerHeap[0];
+    __timer_remove(timer);
+
+    // The heap does not grow, as the timer just left it
+    if (timer->period) {
+      timer->expire += timer->period;
+      __timer_insert(timer);
+    }
+
+    timer->num_fired++;
+    bkl_unlock();
+    timer->callback(timer->arg);
+    bkl_lock();
+  }
+}
 
 //=============================================================================
 // Timer Private Functions
 //=============================================================================
 
+/**
+ * @brief Checks if the first task of the sleep queue has to be awakened.
+ *
+ * @return 1 if there is a task to awake, or 0 otherwise.
+ */
+static int __sleep_due() {
+  return sleepQueue->count && (int)(totalSysTime - nextWakeup) >= 0;
+}
+
+/**
+ * @brief Checks if an awakened task has to preempt the executing one.
+ *
+ * A real-time task preempts a time-sharing task, or a real-time task with a
+ * later deadline. Among the time-sharing tasks, the priority of the awakened
+ * one must be higher by more than the wakeup gap.
+ *
+ * @param task Pointer for the task awakened
+ *
+ * @return 1 if the executing task has to leave the processor, or 0 otherwise.
+ */
+static int __wakeup_preempts(task_t *task) {
+  if (executingTask->type == SYSTEM) {
+    return 0;
+  }
+
+  if (task->rt.period || executingTask->rt.period) {
+    return task->rt.period
+           && (!executingTask->rt.period
+               || (int)(task->rt.abs_deadline - executingTask->rt.abs_deadline)
+                    < 0);
+  }
+
+  return executingTask->initial_priority - task->initial_priority > wakeupGap;
+}
+
+/**
+ * @brief Checks if a sleeping task is more likely to preempt than another.
+ *
+ * A real-time task comes before a time-sharing task, or a real-time task with
+ * a later deadline, and the time-sharing tasks come in order of priority.
+ *
+ * @param task Pointer for the sleeping task
+ * @param other Pointer for the other sleeping task
+ *
+ * @return 1 if the task comes first, or 0 otherwise.
+ */
+static int __sleep_precedes(task_t *task, task_t *other) {
+  if (task->rt.period || other->rt.period) {
+    return task->rt.period
+           && (!other->rt.period
+               || (int)(task->rt.abs_deadline - other->rt.abs_deadline) < 0);
+  }
+
+  return task->initial_priority < other->initial_priority;
+}
+
+/**
+ * @brief Updates the next wakeup once the first task of the sleep queue
+ * changed.
+ *
+ * The tasks that reached their earliest time by the sleep time of the first
+ * one are awakened together with it, and the one among them that is the most
+ * likely to preempt is kept, so the timer checks a single task.
+ */
+static void __sleep_update() {
+  task_t *first = sleepQueue->taskQueue;
+  nextWakeupTask = first;
+  if (first == NULL) {
+    return;
+  }
+
+  nextWakeup = first->sleep_time;
+  for (task_t *aux = first->next;
+       aux != first && (int)(nextWakeup - aux->sleep_early) >= 0;
+       aux = aux->next) {
+    if (__sleep_precedes(aux, nextWakeupTask)) {
+      nextWakeupTask = aux;
+    }
+  }
+}
+
+/**
+ * @brief Checks if a task of the sleep queue that is due preempts the
+ * executing one.
+ *
+ * Only the task kept when the first one changed is checked, as any other task
+ * awakened with it preempts only if this one does.
+ *
+ * Must not be called while the kernel lock is held, as the queue may be in
+ * the middle of a change.
+ *
+ * @return 1 if the executing task has to leave the processor, or 0 otherwise.
+ */
+static int __sleep_preempts() {
+  return __sleep_due() && __wakeup_preempts(nextWakeupTask);
+}
+
 /**
  * @brief Timer interrupt function of the OS
  *
  * The main function of this task is to keep up with the total time of execution
  * of the system, and to manage the total quantum that the current executing
  * task already has consumed of execution, if the executing task has already
- * consumed all its quantum yield it.
+ * consumed all its quantum yield it. A periodic task also consumes the budget of
+ * its job, and a task in a group the processor time of the group, and yields
+ * once it is over. Otherwise the task is only
+ * preempted once a software timer is due, or a sleeping task that preempts it.
+ * A task that can not be preempted only yields once the region is over.
  */
 static void __time_tick() {
   totalSysTime++;
+  lastTickTime = systime_ns();
 
-  if (executingTask->current_time) {
-    executingTask->total_time += totalSysTime - executingTask->current_time;
+  if (executingTask->type == SYSTEM) {
+    return;
   }
-  executingTask->current_time = totalSysTime;
 
-  if (executingTask->type == SYSTEM || !bkl_lock()) {
-    return;
+  if (executingTask->quantum > 0) {
+    executingTask->quantum -= 1;
   }
 
-  executingTask->quantum -= 1;
-  bkl_unlock();
+  // The sleepers that do not preempt the task wait for the end of its quantum,
+  // and the ones due while the lock is held are checked on the next tick
+  int throttled = executingTask->rt.period && __rt_charge(executingTask);
+  if (executingTask->cpu_budget
+      && __budget_charge(executingTask->cpu_budget)) {
+    throttled = 1;
+  }
+  if (executingTask->quantum > 0 && !throttled && !__timer_due()
+      && (bkl_held() || !__sleep_preempts())) {
+    return;
+  }
 
-  if (executingTask->quantum <= 0 || sleepQueue->count) {
-    task_yield();
+  // Inside a kernel critical section the task is preempted when it is over
+  if (executingTask->preempt_count || bkl_held()) {
+    reschedPending = 1;
+    return;
   }
+
+  task_yield();
 }
 
 /**
@@ -118,6 +553,22 @@ static void __aging(void *ptr) {
   }
 }
 
+/**
+ * @brief Gets the quantum of a task.
+ *
+ * @param task Pointer for the task
+ *
+ * @return The quantum set for the task, or the one of its priority in the
+ * quantum table, in milliseconds.
+ */
+static unsigned int __task_quantum(const task_t *task) {
+  if (task->fixed_quantum) {
+    return task->fixed_quantum;
+  }
+
+  return quantumTable[task->initial_priority - TASK_MIN_PRIO];
+}
+
 /**
  * @brief Scheduler function of the OS.
  *
@@ -134,543 +585,1927 @@ static task_t *scheduler() {
     task->current_priority = task->initial_priority;
 
     // Reset the quantum of the task
-    task->quantum = TASK_QUANTUM;
+    task->quantum = __task_quantum(task);
     return task;
   }
 
   return NULL;
 }
 
-//=============================================================================
-// Dispatcher Private Functions
-//=============================================================================
-
 /**
- * @brief Wake up all the tasks awaiting in the queue.
+ * @brief Preempts the executing task, if a tick asked for it meanwhile.
  *
- * This function is responsible for getting all the tasks that are suspended and
- * put then into the ready queue.
+ * Called whenever the task leaves a region where it could not be preempted,
+ * either enabling the preemption or releasing the kernel lock.
+ */
+static void __preempt_resched() {
+  if (reschedPending && executingTask->type != SYSTEM
+      && !executingTask->preempt_count && !bkl_held()) {
+    task_yield();
+  }
+}
+
+/**
+ * @brief Adds time to the state of a task.
  *
- * @param waiting_queue Pointer for the queue with all the tasks to be awaken
- * @param exit_code exit code of the task that was waited
+ * @param times Times of the task
+ * @param state State where the time was spent
+ * @param elapsed Time spent, in nanoseconds
  */
-static void __wakeup_await(task_t **waiting_queue, int exit_code) {
-  task_t *aux = *waiting_queue;
-  while (aux) {
-    task_awake(aux, waiting_queue);
-    aux->waiting_result = exit_code;
-    aux = *waiting_queue;
+static void __times_add(task_times_t *times, task_state state,
+                        unsigned long long elapsed) {
+  switch (state) {
+  case TASK_EXEC:
+    times->run += elapsed;
+    break;
+  case TASK_READY:
+    times->ready += elapsed;
+    break;
+  case TASK_SUSPENDED:
+    times->blocked += elapsed;
+    break;
+  default:
+    break;
   }
 }
 
 /**
- * @brief Wake up all the tasks that passed the sleeping time.
+ * @brief Charges the time since the last change of state of a task.
  *
- * This function is responsible for getting all the tasks that should not be
- * sleeping anymore and put then into the ready queue.
+ * Must be called before every change of state, the time goes to the state
+ * that the task is leaving.
  *
- * @param waiting_queue Pointer for the queue with all the tasks to be awaken
- * @param exit_code exit code of the task that was waited
+ * @param task Pointer for the task
+ * @param now System time, in nanoseconds
  */
-static void __wakeup_sleep(task_t **waiting_queue) {
-  task_t *aux = *waiting_queue;
-  do {
-    if (aux && aux->sleep_time <= totalSysTime) {
-      if (task_manager_remove(sleepQueue, aux) < 0) {
-        log_error("failed to remove sleep task(%d) of sleep queue", aux->tid);
-        exit(1);
-      }
-
-      aux->state = TASK_READY;
-      aux->sleep_time = 0;
-      if (task_manager_insert(readyQueue, aux) < 0) {
-        log_error("failed to insert waiting task(%d) in ready queue", aux->tid);
-        exit(1);
-      }
-
-      numSuspedingTasks--;
-      aux = *waiting_queue;
-    } else {
-      break;
-    }
-  } while (aux);
+static void __task_charge(task_t *task, unsigned long long now) {
+  __times_add(&(task->times), task->state, now - task->state_time);
+  task->state_time = now;
 }
 
+//=============================================================================
+// Mutex Private Functions
+//=============================================================================
+
 /**
- * @brief Wrapper for swapping context with the dispatcher
+ * @brief Gets the highest priority between the tasks waiting for the mutex.
  *
- * @param state The new state for the executing task. This should not be a
- * TASK_EXEC.
+ * @param mutex Pointer for the mutex
+ *
+ * @return The highest priority, or TASK_MAX_PRIO + 1 if there is no task
+ * waiting.
  */
-static void __context_swap_dispatcher(task_state state) {
-  if (state == TASK_EXEC) {
-    log_error("invalid task state");
-    exit(1);
+static int __mutex_waiter_prio(const mutex_t *mutex) {
+  int prio = TASK_MAX_PRIO + 1;
+
+  task_t *aux = mutex->queue;
+  if (aux == NULL) {
+    return prio;
   }
 
-  executingTask->state = state;
-  dispatcherTask->num_calls++;
-  swapcontext(&(executingTask->context), &(dispatcherTask->context));
-}
+  // The queue ordered by priority has the most important task first
+  if (mutex->order) {
+    return aux->initial_priority;
+  }
+
+  do {
+    if (aux->initial_priority < prio) {
+      prio = aux->initial_priority;
+    }
+    aux = aux->next;
+  } while (aux != mutex->queue);
+
+  return prio;
+}
 
 /**
- * @brief Dispatcher task of the OS.
+ * @brief Computes the start priority that a task should have.
  *
- * This function is responsible to add or remove tasks into the queues and to
- * execute the task that the scheduler has choose.
+ * The priority is the highest between the static priority of the task, and the
+ * priority of every task waiting for one of the mutexes that it holds.
+ *
+ * @param task Pointer for the task
+ *
+ * @return The start priority of the task.
  */
-static void dispatcher() {
-  do {
+static int __mutex_inherited_prio(const task_t *task) {
+  int prio = task->static_priority;
 
-    task_t *currentTask = executingTask;
-    dispatcherTask->state = TASK_EXEC;
-    executingTask = dispatcherTask;
+  for (mutex_t *mutex = task->held_mutexes; mutex; mutex = mutex->next_held) {
+    int waiterPrio = __mutex_waiter_prio(mutex);
+    if (waiterPrio < prio) {
+      prio = waiterPrio;
+    }
+  }
 
-    if (task_manager_search(readyQueue, dispatcherTask) == 0) {
-      if (task_manager_remove(readyQueue, dispatcherTask) < 0) {
-        log_error("could not be removed from ready queue");
-        exit(1);
-      }
+  return prio;
+}
+
+/**
+ * @brief Changes the start priority of a task.
+ *
+ * Keeps the aging that the task already received, and if the task is in the
+ * ready queue, or waiting in a queue ordered by priority, reinserts it with the
+ * new priority. The owner of the mutex that the task waits for gets the
+ * priority it inherits again, through the whole chain of owners.
+ *
+ * @param task Pointer for the task that is going to be changed
+ * @param prio The new start priority of the task
+ *
+ * @return 0 if the priority could be adjusted, or 0< otherwise.
+ */
+static int __task_reprio(task_t *task, int prio) {
+  if (task->initial_priority == prio) {
+    return 0;
+  }
+
+  int diffPriority = task->initial_priority - task->current_priority;
+  task->current_priority = prio - diffPriority;
+  task->initial_priority = prio;
+
+  // A task waiting in a queue ordered by priority moves to its new level
+  task_t **queue = task->wait_queue;
+  wait_order_t *order = task->wait_order;
+  mutex_t *mutex = task->waiting_mutex;
+  if (task->state == TASK_SUSPENDED && (order || mutex)) {
+    if (order
+        && (wait_order_remove(queue, order, task) < 0
+            || wait_order_insert(queue, order, task) < 0)) {
+      log_debug("could not move task(%d) in the wait queue", task->tid);
+      return -1;
     }
 
-    switch (currentTask->state) {
-    case TASK_EXEC:      // Only the dispatcher can be in here
-    case TASK_SUSPENDED: // Is already in another queue
-      break;
-    case TASK_READY:
-      if (task_manager_insert(readyQueue, currentTask) < 0) {
-        log_error("failed to insert executing task(%d) in ready queue",
-                  currentTask->tid);
-        exit(1);
-      }
-      break;
-    case TASK_FINISH:
-      __wakeup_await(&currentTask->waiting_queue, currentTask->exit_result);
+    // The owner of the mutex follows the change, either up or down
+    if (mutex && mutex->owner) {
+      return __task_reprio(mutex->owner, __mutex_inherited_prio(mutex->owner));
+    }
 
-      log_info("task(%d) finish. execution time: %d ms, processor time: %d ms, "
-               "%d activations",
-               currentTask->tid, totalSysTime, currentTask->total_time,
-               currentTask->num_calls);
+    return 0;
+  }
 
-      free(currentTask->stack);
-      if (currentTask->tid == MAIN_TASK) {
-        free(currentTask);
-      }
-      break;
-    default:
-      log_error("invalid state(%d))", currentTask->state);
+  // A sleeping task may now be the one checked by the timer
+  if (task->state == TASK_SUSPENDED && task->sleep_time) {
+    __sleep_update();
+    return 0;
+  }
+
+  if (task == executingTask || task->state != TASK_READY) {
+    return 0;
+  }
+
+  // Reinsert the task into the queue with its new priority
+  if (task_manager_remove(readyQueue, task) < 0) {
+    log_debug("could not remove task(%d) from ready queue", task->tid);
+    return -1;
+  }
+
+  if (task_manager_insert(readyQueue, task) < 0) {
+    log_debug("could not insert task(%d) into ready queue", task->tid);
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Lends a priority to the owner of the mutex.
+ *
+ * If the owner is also waiting for another mutex, the priority is lent through
+ * the whole chain of owners.
+ *
+ * @param mutex Pointer for the mutex that the task is going to wait for
+ * @param prio Priority of the task that is going to wait
+ */
+static void __mutex_boost(mutex_t *mutex, int prio) {
+  while (mutex && mutex->owner && prio < mutex->owner->initial_priority) {
+    task_t *owner = mutex->owner;
+    if (__task_reprio(owner, prio) < 0) {
+      log_error("could not boost the priority of task(%d)", owner->tid);
       exit(1);
     }
 
-    __wakeup_sleep(&(sleepQueue->taskQueue));
+    mutex = owner->waiting_mutex;
+  }
+}
 
-    task_t *next = scheduler();
-    if (next == NULL) {
-      log_debug("next task(nil)");
-      continue;
-    }
+/**
+ * @brief Gives the ownership of a mutex to a task.
+ *
+ * @param mutex Pointer for the mutex
+ * @param task Pointer for the task that is going to hold the mutex
+ */
+static void __mutex_acquire(mutex_t *mutex, task_t *task) {
+  mutex->lock = 1;
+  mutex->owner = task;
+  mutex->next_held = task->held_mutexes;
+  task->held_mutexes = mutex;
 
-    task_switch(next);
-  } while (readyQueue->taskQueue || sleepQueue->taskQueue || numSuspedingTasks);
+  mutex->num_acquires++;
+  if (mutex->num_acquires % SPIN_HOLD_SAMPLE == 0) {
+    mutex->hold_start = systime_ns();
+  }
 
-  log_info("task(%d) finish. execution time: %d ms, processor time: %d ms, "
-           "%d activations",
-           dispatcherTask->tid, totalSysTime, dispatcherTask->total_time,
-           dispatcherTask->num_calls);
+  // The task could have taken the mutex ahead of the waiting tasks
+  if (mutex->queue && __task_reprio(task, __mutex_inherited_prio(task)) < 0) {
+    log_error("could not boost the priority of task(%d)", task->tid);
+    exit(1);
+  }
+}
 
-  free(dispatcherTask->stack);
-  free(dispatcherTask);
+/**
+ * @brief Removes the ownership of a mutex from its owner.
+ *
+ * @param mutex Pointer for the mutex
+ */
+static void __mutex_release(mutex_t *mutex) {
+  if (mutex->hold_start) {
+    unsigned long long hold = systime_ns() - mutex->hold_start;
+    mutex->hold_avg = mutex->hold_avg - mutex->hold_avg / SPIN_HOLD_WEIGHT
+      + hold / SPIN_HOLD_WEIGHT;
+    mutex->hold_start = 0;
+  }
+
+  mutex_t **aux = &(mutex->owner->held_mutexes);
+  while (*aux && *aux != mutex) {
+    aux = &((*aux)->next_held);
+  }
+
+  if (*aux) {
+    *aux = mutex->next_held;
+  }
 
-  exit(0);
+  mutex->lock = 0;
+  mutex->owner = NULL;
+  mutex->next_held = NULL;
 }
 
-//=============================================================================
-// Queue Managers Private Functions
-//=============================================================================
+/**
+ * @brief Hands the mutex to the first task waiting for it.
+ *
+ * @param mutex Pointer for the unlocked mutex
+ */
+static void __mutex_give(mutex_t *mutex) {
+  task_t *next = mutex->queue;
+  next->waiting_mutex = NULL;
+  task_awake_order(next, &(mutex->queue), mutex->order);
+  __mutex_acquire(mutex, next);
+}
 
 /**
- * @brief Compare the priority of two tasks
+ * @brief Marks the mutex to be handed to the first task waiting for it.
  *
- * @param ptr1 Pointer for the element that is going to be compared
- * @param ptr2 Pointer for the element in the queue
+ * @param mutex Pointer for the mutex
+ */
+static void __mutex_defer(mutex_t *mutex) {
+  if (mutex->pending) {
+    return;
+  }
+
+  mutex->pending = 1;
+  mutex->next_pending = pendingMutexes;
+  pendingMutexes = mutex;
+}
+
+/**
+ * @brief Removes the mutex of the list of mutexes that need to be handed.
  *
- * @return 0 if equal, 0< if elem has a higher priority, 0> if elem has a lower
- * priority.
+ * @param mutex Pointer for the mutex
  */
-static int __task_comp_prio(const void *ptr1, const void *ptr2) {
-  assert(ptr1 != NULL);
-  assert(ptr2 != NULL);
-  task_t *elem = (task_t *)ptr1;
-  task_t *queue = (task_t *)ptr2;
+static void __mutex_undefer(mutex_t *mutex) {
+  mutex_t **aux = &pendingMutexes;
+  while (*aux && *aux != mutex) {
+    aux = &((*aux)->next_pending);
+  }
 
-  return elem->initial_priority - queue->current_priority;
+  if (*aux) {
+    *aux = mutex->next_pending;
+  }
+
+  mutex->pending = 0;
+  mutex->next_pending = NULL;
 }
 
 /**
- * @brief Initializer for the ready queue.
+ * @brief Hands the unlocked mutexes to the first task waiting for them.
+ *
+ * The mutexes are unlocked with tasks waiting while the owner is executing, as
+ * the waiting task could not execute before that. So the mutex only changes of
+ * owner here, if no other task took it in the meantime.
  */
-static void __ppos_init_ready_queue() {
-  readyQueue = task_manager_create("ready", __task_comp_prio);
-  if (readyQueue == NULL) {
-    log_error("couldn't initiate queue");
-    exit(1);
+static void __mutex_handoff() {
+  while (pendingMutexes) {
+    mutex_t *mutex = pendingMutexes;
+    pendingMutexes = mutex->next_pending;
+    mutex->pending = 0;
+    mutex->next_pending = NULL;
+
+    if (!mutex->lock && mutex->queue) {
+      __mutex_give(mutex);
+    }
   }
 }
 
 /**
- * @brief Compare the sleep time of two tasks
+ * @brief Unlocks the mutex held by the executing task.
  *
- * @param ptr1 Pointer for the element that is going to be compared
- * @param ptr2 Pointer for the element in the queue
+ * A waiter more important than the task gets the mutex right away, so the task
+ * can not take it back. Otherwise the mutex is handed to the first waiter once
+ * the task leaves the processor.
  *
- * @return 0 if equal, 0< if elem has a higher sleep time, 0> if elem has a
- * lower sleep time.
+ * @param mutex Pointer for the mutex
  */
-static int __task_comp_time(const void *ptr1, const void *ptr2) {
-  assert(ptr1 != NULL);
-  assert(ptr2 != NULL);
-  task_t *elem = (task_t *)ptr1;
-  task_t *queue = (task_t *)ptr2;
+static void __mutex_unlock(mutex_t *mutex) {
+  __mutex_release(mutex);
 
-  if (elem->sleep_time == queue->sleep_time) {
-    return 0;
-  } else if (elem->sleep_time > queue->sleep_time) {
-    return 1;
-  } else {
-    return -1;
+  if (__mutex_waiter_prio(mutex) < executingTask->static_priority) {
+    __mutex_give(mutex);
+  } else if (mutex->queue) {
+    __mutex_defer(mutex);
   }
+
+  __task_reprio(executingTask, __mutex_inherited_prio(executingTask));
 }
 
 /**
- * @brief Initializer for the sleep queue.
+ * @brief Moves the first task waiting for the condition to its mutex.
+ *
+ * The task stays suspended, but now in the queue of the mutex, lending its
+ * priority to the owner. If the mutex is unlocked it is handed to the task the
+ * next time the dispatcher executes.
+ *
+ * @param cond Pointer for the condition variable
+ * @param signaled 1 if the task was signaled, and 0 if the condition variable
+ * was destroyed
  */
-static void __ppos_init_sleep_queue() {
-  sleepQueue = task_manager_create("sleep", __task_comp_time);
-  if (sleepQueue == NULL) {
-    log_error("couldn't initiate queue");
+static void __cond_morph(cond_t *cond, int signaled) {
+  task_t *task = cond->queue;
+  mutex_t *mutex = cond->mutex;
+  task->cond_signaled = signaled;
+
+  // The mutex was destroyed, so there is nothing to wait for
+  if (mutex->lock < 0) {
+    task_awake(task, &(cond->queue));
+    return;
+  }
+
+  if (queue_remove((queue_t **)&(cond->queue), (queue_t *)task) < 0) {
+    log_error("could not remove task(%d) from the condition queue", task->tid);
+    exit(1);
+  }
+
+  if (wait_order_insert(&(mutex->queue), mutex->order, task) < 0) {
+    log_error("could not add task(%d) to the mutex queue", task->tid);
     exit(1);
   }
+
+  task->waiting_mutex = mutex;
+  __mutex_boost(mutex, task->initial_priority);
+
+  if (!mutex->lock) {
+    __mutex_defer(mutex);
+  }
 }
 
 /**
- * @brief Initializes the task structures of the OS.
+ * @brief Yields waiting for the mutex to be unlocked.
  *
- * Initialize the manager of the queues. Starts the current task
- * (the one that called this function), as the main task, and initialized the
- * dispatcher task.
+ * The task only yields if the mutex is usually held for a short time, if the
+ * owner would get to execute, and if there is no task suspended waiting for it,
+ * otherwise it is better to suspend right away.
+ *
+ * @param mutex Pointer for the mutex
+ *
+ * @return 0 if the mutex was locked while yielding, and -1 otherwise.
  */
-static void __ppos_init_main_task() {
-  executingTask = malloc(sizeof(task_t));
-  if (executingTask == NULL) {
-    log_error("failed to allocate");
-    exit(1);
+static int __mutex_spin(mutex_t *mutex) {
+  if (mutex->hold_avg > SPIN_MAX_HOLD) {
+    return -1;
   }
 
-  if (task_init(executingTask, NULL, NULL) < 0) {
-    log_error("could not be initialized");
-    exit(1);
+  for (int i = 0; i < mutex->spin_limit; i++) {
+    // The mutex is handed to the suspended tasks first
+    if (mutex->queue) {
+      return -1;
+    }
+
+    task_t *owner = mutex->owner;
+    if (owner && owner->initial_priority > executingTask->initial_priority) {
+      return -1;
+    }
+
+    mutex->num_spins++;
+    task_yield();
+
+    if (mutex->lock < 0) {
+      return -1;
+    }
+
+    bkl_spinlock();
+    if (!mutex->lock) {
+      mutex->num_spin_acquires++;
+      __mutex_acquire(mutex, executingTask);
+      bkl_unlock();
+      return 0;
+    }
+    bkl_unlock();
   }
+
+  return -1;
 }
 
+//=============================================================================
+// Dispatcher Private Functions
+//=============================================================================
+
 /**
- * @brief Initializes the task structures of the OS.
+ * @brief Wake up all the tasks awaiting in the queue.
  *
- * Initialize the manager of the queues. Starts the current task
- * (the one that called this function), as the main task, and initialized the
- * dispatcher task.
+ * This function is responsible for getting all the tasks that are suspended and
+ * put then into the ready queue.
+ *
+ * @param waiting_queue Pointer for the queue with all the tasks to be awaken
+ * @param exit_code exit code of the task that was waited
  */
-static void __ppos_init_disp_task() {
-  dispatcherTask = malloc(sizeof(task_t));
-  if (dispatcherTask == NULL) {
-    log_error("failed to allocate dispatcher task");
-    exit(1);
+static void __wakeup_await(task_t **waiting_queue, int exit_code) {
+  task_t *aux = *waiting_queue;
+  if (aux == NULL) {
+    return;
   }
 
-  if (task_init(dispatcherTask, dispatcher, NULL) < 0) {
-    log_error("dispatcher task could not be initialized");
-    exit(1);
+  do {
+    aux->waiting_result = exit_code;
+    aux = aux->next;
+  } while (aux != *waiting_queue);
+
+  task_awake_all(waiting_queue);
+}
+
+/**
+ * @brief Counts the end of the task in the groups waiting for it.
+ *
+ * The waiting task of each group is awakened once the last task it needs has
+ * finished.
+ *
+ * @param task Pointer for the task that finished
+ */
+static void __wakeup_groups(task_t *task) {
+  for (wait_entry_t *aux = task->wait_entries; aux; aux = aux->next) {
+    wait_group_t *group = aux->group;
+    if (group->first < 0) {
+      group->first = aux->index;
+    }
+
+    group->remaining--;
+    if (group->remaining == 0) {
+      task_awake_all(&(group->queue));
+    }
   }
-  dispatcherTask->type = SYSTEM;
+}
+
+/**
+ * @brief Wake up all the tasks that passed the sleeping time.
+ *
+ * This function is responsible for getting all the tasks that should not be
+ * sleeping anymore and put then into the ready queue. The queue is ordered by
+ * the latest time of each task, and the tasks that reached the earliest one
+ * are awakened together, so tasks with slack share a single pass.
+ *
+ * @param waiting_queue Pointer for the queue with all the tasks to be awaken
+ * @param exit_code exit code of the task that was waited
+ */
+static void __wakeup_sleep(task_t **waiting_queue) {
+  task_t *aux = *waiting_queue;
+  unsigned long long now = 0;
+  do {
+    // A task within its slack is awakened with the ones that are due
+    if (aux && (int)(totalSysTime - aux->sleep_early) >= 0) {
+      if (task_manager_remove(sleepQueue, aux) < 0) {
+        log_error("failed to remove sleep task(%d) of sleep queue", aux->tid);
+        exit(1);
+      }
+
+      if (!now) {
+        now = systime_ns();
+      }
+
+      __task_charge(aux, now);
+      aux->state = TASK_READY;
+      aux->sleep_time = 0;
+      if (task_manager_insert(readyQueue, aux) < 0) {
+        log_error("failed to insert waiting task(%d) in ready queue", aux->tid);
+        exit(1);
+      }
+
+      numSuspedingTasks--;
+      aux = *waiting_queue;
+    } else {
+      break;
+    }
+  } while (aux);
+
+  __sleep_update();
+}
+
+/**
+ * @brief Wrapper for swapping context with the dispatcher
+ *
+ * @param state The new state for the executing task. This should not be a
+ * TASK_EXEC.
+ */
+static void __context_swap_dispatcher(task_state state) {
+  if (state == TASK_EXEC) {
+    log_error("invalid task state");
+    exit(1);
+  }
+
+  // Not preempted while leaving the processor, the lock is released once the
+  // task executes again
+  bkl_lock();
+  unsigned long long now = systime_ns();
+  __task_charge(executingTask, now);
+  __task_charge(dispatcherTask, now);
+  executingTask->state = state;
+  dispatcherTask->num_calls++;
+  swapcontext(&(executingTask->context), &(dispatcherTask->context));
+  bkl_unlock();
+}
+
+/**
+ * @brief Inserts a task in the sleep queue.
+ *
+ * @param task Pointer for the task
+ * @param time System time to awake the task, in milliseconds
+ * @param slack Delay accepted after the time, in milliseconds
+ */
+static void __sleep_insert(task_t *task, unsigned int time,
+                           unsigned int slack) {
+  task->sleep_early = time;
+  task->sleep_time = time + slack;
+  if (task_manager_insert(sleepQueue, task) < 0) {
+    log_error("could not add task(%d) to the sleep queue", task->tid);
+    exit(1);
+  }
+
+  __sleep_update();
+  numSuspedingTasks++;
+}
+
+/**
+ * @brief Suspends a periodic task until its next release.
+ *
+ * Used once the job consumed all of its budget, the rest of the job executes
+ * in the next period with a new budget and deadline.
+ *
+ * @param task Pointer for the periodic task, that left the processor
+ */
+static void __rt_throttle(task_t *task) {
+  __rt_check_miss(task);
+  task->rt.stats.throttles++;
+  __rt_next_job(task);
+
+  __task_charge(task, systime_ns());
+  task->state = TASK_SUSPENDED;
+  __sleep_insert(task, task->rt.release, 0);
+}
+
+/**
+ * @brief Parks a task until the replenishment of its group.
+ *
+ * Used once the group used all of its processor time, either when the task
+ * leaves the processor or when it is scheduled.
+ *
+ * @param task Pointer for the task, that is not executing nor in a queue
+ */
+static void __budget_throttle(task_t *task) {
+  task->cpu_budget->num_throttles++;
+  __task_charge(task, systime_ns());
+  task->state = TASK_SUSPENDED;
+  __sleep_insert(task, task->cpu_budget->replenish, 0);
+}
+
+/**
+ * @brief Puts the executing task in the sleep queue until a system time.
+ *
+ * Must be called holding the kernel lock, that is released once the task
+ * executes again.
+ *
+ * @param time System time to awake the task, in milliseconds
+ */
+static void __sleep_until(unsigned int time) {
+  // The releases of a periodic task are not delayed
+  __sleep_insert(executingTask, time,
+                 executingTask->rt.period ? 0 : executingTask->timer_slack);
+  __context_swap_dispatcher(TASK_SUSPENDED);
+}
+
+/**
+ * @brief Entry point of every task.
+ *
+ * Releases the lock held by the dispatcher while switching to the task, before
+ * executing its start routine. The dispatcher itself starts from the task that
+ * left the processor, and keeps the lock.
+ *
+ * @param start_routine Function executed by the task
+ * @param arg Argument passed to the function
+ */
+static void __task_start(void (*start_routine)(void *), void *arg) {
+  if (executingTask->state == TASK_EXEC) {
+    bkl_unlock();
+  }
+
+  start_routine(arg);
+}
+
+/**
+ * @brief Waits without using the processor until a task or a timer is due.
+ *
+ * The timer signal is blocked while checking, so a tick between the check and
+ * the wait is not lost, and only delivered while waiting. The ticks themselves
+ * do not preempt the dispatcher.
+ */
+static void __dispatcher_idle() {
+  sigset_t alarm, old, wait;
+  sigemptyset(&alarm);
+  sigaddset(&alarm, SIGALRM);
+  sigprocmask(SIG_BLOCK, &alarm, &old);
+
+  // The dispatcher may have been entered from the timer signal, blocking it
+  wait = old;
+  sigdelset(&wait, SIGALRM);
+  while ((sleepQueue->count || timerCount) && !__sleep_due()
+         && !__timer_due()) {
+    sigsuspend(&wait);
+  }
+
+  sigprocmask(SIG_SETMASK, &old, NULL);
+}
+
+/**
+ * @brief Dispatcher task of the OS.
+ *
+ * This function is responsible to add or remove tasks into the queues and to
+ * execute the task that the scheduler has choose.
+ */
+static void dispatcher() {
+  do {
+
+    task_t *currentTask = executingTask;
+    dispatcherTask->state = TASK_EXEC;
+    executingTask = dispatcherTask;
+
+    // The task already left the processor
+    reschedPending = 0;
+
+    // Held until the next task is executing, as a tick while switching to it
+    // would save the dispatcher in the context of the task
+    bkl_lock();
+
+    switch (currentTask->state) {
+    case TASK_EXEC:      // Only the dispatcher can be in here
+    case TASK_SUSPENDED: // Is already in another queue
+      break;
+    case TASK_READY:
+      // A periodic task that consumed its budget waits for the next release
+      if (currentTask->rt.period
+          && currentTask->rt.used >= currentTask->rt.budget) {
+        __rt_throttle(currentTask);
+        break;
+      }
+
+      // A task of a group without processor time waits for the replenishment
+      if (currentTask->cpu_budget
+          && __budget_depleted(currentTask->cpu_budget)) {
+        __budget_throttle(currentTask);
+        break;
+      }
+
+      if (task_manager_insert(readyQueue, currentTask) < 0) {
+        log_error("failed to insert executing task(%d) in ready queue",
+                  currentTask->tid);
+        exit(1);
+      }
+      break;
+    case TASK_FINISH:
+      __wakeup_await(&currentTask->waiting_queue, currentTask->exit_result);
+      __wakeup_groups(currentTask);
+      if (currentTask->cpu_budget) {
+        currentTask->cpu_budget->num_tasks--;
+      }
+
+      log_info("task(%d) finish. execution time: %d ms, processor time: %llu "
+               "us, ready time: %llu us, blocked time: %llu us, %d activations",
+               currentTask->tid, totalSysTime, currentTask->times.run / 1000,
+               currentTask->times.ready / 1000,
+               currentTask->times.blocked / 1000, currentTask->num_calls);
+
+      free(currentTask->stack);
+      if (currentTask->tid == MAIN_TASK) {
+        free(currentTask);
+      }
+      break;
+    default:
+      log_error("invalid state(%d))", currentTask->state);
+      exit(1);
+    }
+
+    // The callbacks may release semaphores, handed right after
+    __timer_fire();
+
+    // The locks released by the last task go to the tasks waiting for them
+    __mutex_handoff();
+    sem_handoff();
+
+    __wakeup_sleep(&(sleepQueue->taskQueue));
+
+    // The other tasks of a group without processor time are parked as well
+    // The tasks of groups without processor time are parked before choosing,
+    // so the other ones are aged once for each task chosen
+    task_t *first = readyQueue->taskQueue;
+    while (first && first->cpu_budget && __budget_depleted(first->cpu_budget)) {
+      if (task_manager_remove(readyQueue, first) < 0) {
+        log_error("failed to remove task(%d) of the ready queue", first->tid);
+        exit(1);
+      }
+
+      __budget_throttle(first);
+      first = readyQueue->taskQueue;
+    }
+
+    task_t *next = scheduler();
+
+    if (next == NULL) {
+      log_debug("next task(nil)");
+      __dispatcher_idle();
+      continue;
+    }
+
+    task_switch(next);
+  } while (readyQueue->taskQueue || sleepQueue->taskQueue || numSuspedingTasks
+           || timerCount);
+
+  log_info("task(%d) finish. execution time: %d ms, processor time: %llu us, "
+           "ready time: %llu us, %d activations",
+           dispatcherTask->tid, totalSysTime, dispatcherTask->times.run / 1000,
+           dispatcherTask->times.ready / 1000, dispatcherTask->num_calls);
+
+  free(dispatcherTask->stack);
+  free(dispatcherTask);
+  free(timerHeap);
+
+  exit(mainTask->exit_result);
+}
+
+//=============================================================================
+// Queue Managers Private Functions
+//=============================================================================
+
+/**
+ * @brief Compare the priority of two tasks
+ *
+ * @param ptr1 Pointer for the element that is going to be compared
+ * @param ptr2 Pointer for the element in the queue
+ *
+ * @return 0 if equal, 0< if elem has a higher priority, 0> if elem has a lower
+ * priority. A periodic task has a higher priority than every time-sharing one.
+ */
+static int __task_comp_prio(const void *ptr1, const void *ptr2) {
+  assert(ptr1 != NULL);
+  assert(ptr2 != NULL);
+  task_t *elem = (task_t *)ptr1;
+  task_t *queue = (task_t *)ptr2;
+
+  // The real-time class comes before the time-sharing one, and inside it the
+  // earliest deadline first
+  if (elem->rt.period && queue->rt.period) {
+    return (int)(elem->rt.abs_deadline - queue->rt.abs_deadline);
+  } else if (elem->rt.period || queue->rt.period) {
+    return elem->rt.period ? -1 : 1;
+  }
+
+  return elem->initial_priority - queue->current_priority;
+}
+
+/**
+ * @brief Initializer for the ready queue.
+ */
+static void __ppos_init_ready_queue() {
+  readyQueue = task_manager_create("ready", __task_comp_prio);
+  if (readyQueue == NULL) {
+    log_error("couldn't initiate queue");
+    exit(1);
+  }
+}
+
+/**
+ * @brief Compare the sleep time of two tasks
+ *
+ * @param ptr1 Pointer for the element that is going to be compared
+ * @param ptr2 Pointer for the element in the queue
+ *
+ * @return 0 if equal, 0< if elem has a higher sleep time, 0> if elem has a
+ * lower sleep time.
+ */
+static int __task_comp_time(const void *ptr1, const void *ptr2) {
+  assert(ptr1 != NULL);
+  assert(ptr2 != NULL);
+  task_t *elem = (task_t *)ptr1;
+  task_t *queue = (task_t *)ptr2;
+
+  if (elem->sleep_time == queue->sleep_time) {
+    return 0;
+  } else if (elem->sleep_time > queue->sleep_time) {
+    return 1;
+  } else {
+    return -1;
+  }
+}
+
+/**
+ * @brief Initializer for the sleep queue.
+ */
+static void __ppos_init_sleep_queue() {
+  sleepQueue = task_manager_create("sleep", __task_comp_time);
+  if (sleepQueue == NULL) {
+    log_error("couldn't initiate queue");
+    exit(1);
+  }
+}
+
+/**
+ * @brief Initializes the task structures of the OS.
+ *
+ * Initialize the manager of the queues. Starts the current task
+ * (the one that called this function), as the main task, and initialized the
+ * dispatcher task.
+ */
+static void __ppos_init_main_task() {
+  executingTask = malloc(sizeof(task_t));
+  if (executingTask == NULL) {
+    log_error("failed to allocate");
+    exit(1);
+  }
+
+  if (task_init(executingTask, NULL, NULL) < 0) {
+    log_error("could not be initialized");
+    exit(1);
+  }
+
+  mainTask = executingTask;
+}
+
+/**
+ * @brief Initializes the task structures of the OS.
+ *
+ * Initialize the manager of the queues. Starts the current task
+ * (the one that called this function), as the main task, and initialized the
+ * dispatcher task.
+ */
+static void __ppos_init_disp_task() {
+  dispatcherTask = malloc(sizeof(task_t));
+  if (dispatcherTask == NULL) {
+    log_error("failed to allocate dispatcher task");
+    exit(1);
+  }
+
+  if (task_init(dispatcherTask, dispatcher, NULL) < 0) {
+    log_error("dispatcher task could not be initialized");
+    exit(1);
+  }
+  dispatcherTask->type = SYSTEM;
+
+  // Executes whenever a task leaves the processor, and is never scheduled
+  if (task_manager_remove(readyQueue, dispatcherTask) < 0) {
+    log_error("could not be removed from ready queue");
+    exit(1);
+  }
+}
+
+//=============================================================================
+// General Public Functions
+//=============================================================================
+
+void ppos_init() {
+  // Removes the virtual buffer of the output
+  // https://en.cppreference.com/w/c/io/setvbuf
+  (void)setvbuf(stdout, 0, _IONBF, 0);
+
+  log_set(stderr, 0, LOG_FATAL);
+
+  // Started first, as the tasks keep the time of their changes of state
+  clock_gettime(CLOCK_MONOTONIC, &startSysTime);
+
+  // A tick deferred by the kernel lock is handled once the lock is released
+  bkl_init(__preempt_resched);
+  task_set_quantum_table(NULL);
+
+  __ppos_init_ready_queue();
+  __ppos_init_sleep_queue();
+  __ppos_init_main_task();
+  __ppos_init_disp_task();
+  __ppos_init_timer();
+}
+
+unsigned int systime() { return totalSysTime; }
+
+unsigned long long systime_ns() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (unsigned long long)(now.tv_sec - startSysTime.tv_sec) * 1000000000ULL
+    + (unsigned long long)now.tv_nsec - (unsigned long long)startSysTime.tv_nsec;
+}
+
+//=============================================================================
+// Task Public Management
+//=============================================================================
+
+int task_init(task_t *task, void (*start_routine)(void *), void *arg) {
+  static int threadCount = 0;
+
+  if (task == NULL) {
+    log_error("received a task == NULL");
+    return -1;
+  }
+
+  if (threadCount != MAIN_TASK && start_routine == NULL) {
+    log_error("received a start_routine == NULL");
+    return -1;
+  }
+
+  task->next = NULL;
+  task->prev = NULL;
+  task->tid = threadCount;
+  task->static_priority = 0;
+  task->initial_priority = 0;
+  task->current_priority = 0;
+  task->type = USER;
+  task->quantum = TASK_QUANTUM;
+  task->fixed_quantum = 0;
+  task->times.run = 0;
+  task->times.ready = 0;
+  task->times.blocked = 0;
+  task->state_time = systime_ns();
+  task->sleep_time = 0;
+  task->num_calls = 0;
+  task->exit_result = 0;
+  task->waiting_queue = NULL;
+  task->waiting_result = 0;
+  task->held_mutexes = NULL;
+  task->waiting_mutex = NULL;
+  task->wait_entries = NULL;
+  task->sem_units = 0;
+  task->wait_level = 0;
+  task->wait_queue = NULL;
+  task->wait_order = NULL;
+  task->event_bits = 0;
+  task->event_flags = 0;
+  task->cond_signaled = 0;
+  task->rt = (task_rt_t){0};
+  task->preempt_count = 0;
+  task->timer_slack = 0;
+  task->cpu_budget = NULL;
+
+  if (threadCount == MAIN_TASK) {
+    task->state = TASK_EXEC;
+    task->stack = NULL; // Main task does not need to allocate a stack
+    getcontext(&(task->context));
+  } else {
+    task->state = TASK_READY;
+
+    // Initialize the context structure and its stack
+    getcontext(&(task->context));
+    char *stack = malloc((size_t)STACKSIZE);
+    if (stack) {
+      task->context.uc_stack.ss_sp = stack;
+      task->context.uc_stack.ss_size = (size_t)STACKSIZE;
+      task->context.uc_stack.ss_flags = 0;
+      task->context.uc_link = 0;
+    } else {
+      log_error("stack could not be allocated");
+      return -1;
+    }
+    makecontext(&(task->context), (void *)__task_start, 2, start_routine, arg);
+
+    bkl_spinlock();
+    if (task_manager_insert(readyQueue, task) < 0) {
+      bkl_unlock();
+      log_debug("task(%d) could not be appended in the ready queue", task->tid);
+      return -1;
+    }
+    bkl_unlock();
+  }
+
+  threadCount++;
+  return 0;
+}
+
+int task_switch(task_t *task) {
+  if (task == NULL) {
+    log_debug("received task == NULL");
+    return -1;
+  }
+
+  log_debug("(%d)->(%d)", executingTask->tid, task->tid);
+  task->num_calls++;
+
+  if (task_manager_remove(readyQueue, task) < 0) {
+    log_debug("could not remove task(%d) from ready queue", task->tid);
+    return -1;
+  }
+
+  if (executingTask != dispatcherTask
+      && task_manager_insert(readyQueue, executingTask) < 0) {
+    log_debug("could not insert task(%d) into ready queue", executingTask->tid);
+    return -1;
+  }
+
+  unsigned long long now = systime_ns();
+  __task_charge(task, now);
+  __task_charge(executingTask, now);
+
+  task_t *temp = executingTask;
+  executingTask = task;
+  task->state = TASK_EXEC;
+  temp->state = TASK_READY;
+
+  swapcontext(&(temp->context), &(executingTask->context));
+
+  // The dispatcher keeps the lock until it switches to the next task
+  if (temp != dispatcherTask) {
+    bkl_unlock();
+  }
+  return 0;
+}
+
+void task_exit(int exit_code) {
+  log_debug("task(%d)", executingTask->tid);
+  executingTask->exit_result = exit_code;
+  __context_swap_dispatcher(TASK_FINISH);
+}
+
+int task_id() {
+  log_debug("%d", executingTask->tid);
+  return executingTask->tid;
+}
+
+task_t *task_self() { return executingTask; }
+
+void task_yield() {
+  log_debug("task(%d)", executingTask->tid);
+  __context_swap_dispatcher(TASK_READY);
+}
+
+int task_getprio(const task_t *const task) {
+  if (task == NULL) {
+    return executingTask->static_priority;
+  }
+
+  return task->static_priority;
+}
+
+int task_set_quantum_table(const int *table) {
+  for (int i = 0; table && i < QUANTUM_LEVELS; i++) {
+    if (table[i] <= 0) {
+      log_debug("invalid quantum(%d) for priority %d", table[i],
+                i + TASK_MIN_PRIO);
+      return -1;
+    }
+  }
+
+  // The tasks get the new quantum the next time they are scheduled
+  bkl_spinlock();
+  for (int i = 0; i < QUANTUM_LEVELS; i++) {
+    quantumTable[i] = table ? (unsigned int)table[i] : TASK_QUANTUM;
+  }
+  bkl_unlock();
+  return 0;
+}
+
+int task_set_quantum(task_t *task, int quantum) {
+  if (quantum < 0) {
+    return -1;
+  }
+
+  if (task == NULL) {
+    task = executingTask;
+  }
+
+  task->fixed_quantum = (unsigned int)quantum;
+  return 0;
+}
+
+int task_get_quantum(const task_t *task) {
+  if (task == NULL) {
+    task = executingTask;
+  }
+
+  return (int)__task_quantum(task);
+}
+
+int task_times(const task_t *task, task_times_t *times) {
+  if (times == NULL) {
+    return -1;
+  }
+
+  if (task == NULL) {
+    task = executingTask;
+  }
+
+  // Adds the time in the current state, that was not charged yet. Not
+  // preempted in between, or the task could be charged after the copy
+  bkl_spinlock();
+  *times = task->times;
+  __times_add(times, task->state, systime_ns() - task->state_time);
+  bkl_unlock();
+  return 0;
+}
+
+int task_setprio(task_t *task, int prio) {
+  if (prio > TASK_MAX_PRIO || prio < TASK_MIN_PRIO) {
+    return -1;
+  }
+
+  task_t *aux = NULL;
+  if (task == NULL) {
+    aux = executingTask;
+  } else {
+    aux = task;
+  }
+
+  bkl_spinlock();
+  aux->static_priority = prio;
+  int ret = __task_reprio(aux, __mutex_inherited_prio(aux));
+  bkl_unlock();
+  return ret;
+}
+
+int task_wait(task_t *task) {
+  if (task == NULL) {
+    log_error("receive a NULL task");
+    return -1;
+  }
+
+  bkl_spinlock();
+  if (task->state == TASK_FINISH) {
+    bkl_unlock();
+    log_error("task(%d) already finished", task->tid);
+    return -1;
+  }
+
+  log_debug("task(%d) waiting task(%d)", executingTask->tid, task->tid);
+  task_suspend(&(task->waiting_queue));
+  return executingTask->waiting_result;
+}
+
+/**
+ * @brief Waits until enough tasks of the set have finished.
+ *
+ * @param tasks Array with the pointers for the tasks being waited.
+ * @param num Number of tasks in the array.
+ * @param needed Number of tasks that need to finish.
+ *
+ * @return The index of the first task to finish, and -1 on error.
+ */
+static int __task_wait_group(task_t **tasks, int num, int needed) {
+  if (tasks == NULL || num <= 0) {
+    log_error("received an empty set of tasks");
+    return -1;
+  }
+
+  for (int i = 0; i < num; i++) {
+    if (tasks[i] == NULL || tasks[i] == executingTask) {
+      log_error("invalid task in the position %d", i);
+      return -1;
+    }
+  }
+
+  wait_group_t group = {.queue = NULL, .remaining = needed, .first = -1};
+
+  bkl_spinlock();
+  for (int i = 0; i < num; i++) {
+    if (tasks[i]->state == TASK_FINISH) {
+      if (group.first < 0) {
+        group.first = i;
+      }
+      group.remaining--;
+    }
+  }
+
+  if (group.remaining <= 0) {
+    bkl_unlock();
+    return group.first;
+  }
+
+  wait_entry_t *entries = calloc((size_t)num, sizeof(wait_entry_t));
+  if (entries == NULL) {
+    bkl_unlock();
+    log_error("could not allocate the wait group");
+    return -1;
+  }
+
+  for (int i = 0; i < num; i++) {
+    if (tasks[i]->state != TASK_FINISH) {
+      entries[i].group = &group;
+      entries[i].index = i;
+      entries[i].next = tasks[i]->wait_entries;
+      tasks[i]->wait_entries = &(entries[i]);
+    }
+  }
+
+  log_debug("task(%d) waiting %d of %d tasks", executingTask->tid, needed, num);
+  task_suspend(&(group.queue));
+
+  bkl_spinlock();
+  for (int i = 0; i < num; i++) {
+    wait_entry_t **aux = &(tasks[i]->wait_entries);
+    while (*aux && *aux != &(entries[i])) {
+      aux = &((*aux)->next);
+    }
+
+    if (*aux) {
+      *aux = entries[i].next;
+    }
+  }
+  bkl_unlock();
+
+  free(entries);
+  return group.first;
+}
+
+int task_wait_all(task_t **tasks, int num, int *exit_codes) {
+  if (__task_wait_group(tasks, num, num) < 0) {
+    return -1;
+  }
+
+  for (int i = 0; exit_codes && i < num; i++) {
+    exit_codes[i] = tasks[i]->exit_result;
+  }
+
+  return 0;
+}
+
+int task_wait_any(task_t **tasks, int num, int *exit_code) {
+  int index = __task_wait_group(tasks, num, 1);
+  if (index < 0) {
+    return -1;
+  }
+
+  if (exit_code) {
+    *exit_code = tasks[index]->exit_result;
+  }
+
+  return index;
+}
+
+void task_suspend(task_t **queue) { task_suspend_order(queue, NULL); }
+
+void task_suspend_order(task_t **queue, wait_order_t *order) {
+  log_debug("suspending task(%d)", executingTask->tid);
+
+  // Kept until the dispatcher takes over, as a tick in between would also
+  // insert the task in the ready queue. The caller may already hold it, to
+  // check the condition it waits for and suspend without being preempted.
+  bkl_lock();
+  if (wait_order_insert(queue, order, executingTask) < 0) {
+    log_error("could not add task(%d) to the suspend queue",
+              executingTask->tid);
+    exit(1);
+  }
+
+  numSuspedingTasks++;
+  __context_swap_dispatcher(TASK_SUSPENDED);
+}
+
+void task_awake(task_t *task, task_t **queue) {
+  task_awake_order(task, queue, NULL);
+}
+
+void task_awake_order(task_t *task, task_t **queue, wait_order_t *order) {
+  if (task == NULL) {
+    log_error("received a NULL task");
+    exit(1);
+  }
+
+  if (queue == NULL) {
+    log_error("received a NULL queue");
+    exit(1);
+  }
+
+  if (wait_order_remove(queue, order, task) < 0) {
+    log_error("could not awake task(%d)", task->tid);
+    exit(1);
+  }
+
+  __task_charge(task, systime_ns());
+  task->state = TASK_READY;
+  if (task_manager_insert(readyQueue, task) < 0) {
+    log_error("failed to insert waiting task(%d) in ready queue", task->tid);
+    exit(1);
+  }
+
+  numSuspedingTasks--;
+
+  // Switches once the kernel lock is released, if the caller holds it
+  if (__wakeup_preempts(task)) {
+    reschedPending = 1;
+    __preempt_resched();
+  }
+}
+
+int task_awake_all(task_t **queue) {
+  if (queue == NULL) {
+    log_error("received a NULL queue");
+    exit(1);
+  }
+
+  if (*queue == NULL) {
+    return 0;
+  }
+
+  unsigned long long now = systime_ns();
+  int preempts = 0;
+  task_t *aux = *queue;
+  do {
+    __task_charge(aux, now);
+    aux->state = TASK_READY;
+    aux->wait_queue = NULL;
+    aux->wait_order = NULL;
+    preempts = preempts || __wakeup_preempts(aux);
+    aux = aux->next;
+  } while (aux != *queue);
+
+  int count = task_manager_splice(readyQueue, queue);
+  if (count < 0) {
+    log_error("failed to insert waiting tasks in ready queue");
+    exit(1);
+  }
+
+  numSuspedingTasks -= count;
+  if (preempts) {
+    reschedPending = 1;
+    __preempt_resched();
+  }
+
+  return count;
+}
+
+void task_sleep(int time) {
+  log_debug("sleeping task(%d)", executingTask->tid);
+  if (time < 0) {
+    log_debug("time passed is negative");
+    return;
+  }
+
+  bkl_spinlock();
+  __sleep_until((unsigned int)time + totalSysTime);
+}
+
+int task_sleep_until(unsigned long long deadline) {
+  log_debug("sleeping task(%d) until %llu ns", executingTask->tid, deadline);
+
+  bkl_spinlock();
+  unsigned long long now = systime_ns();
+  if (now >= deadline) {
+    bkl_unlock();
+    return 1;
+  }
+
+  // Sleeps until the first tick after the deadline, counted from the last one.
+  // A tick that is late sleeps the task once more, until the deadline passed
+  do {
+    unsigned long long ticks =
+      (deadline - lastTickTime + TICK_NS - 1) / TICK_NS;
+    __sleep_until(totalSysTime + (unsigned int)(ticks ? ticks : 1));
+    bkl_spinlock();
+    now = systime_ns();
+  } while (now < deadline);
+
+  bkl_unlock();
+  return 0;
+}
+
+int task_sleep_next(unsigned long long *deadline, unsigned long long period) {
+  if (deadline == NULL || period == 0) {
+    return -1;
+  }
+
+  *deadline += period;
+  return task_sleep_until(*deadline);
+}
+
+int task_set_slack(task_t *task, int slack) {
+  if (slack < 0) {
+    return -1;
+  }
+
+  if (task == NULL) {
+    task = executingTask;
+  }
+
+  // Applied from the next time the task sleeps
+  task->timer_slack = (unsigned int)slack;
+  return 0;
+}
+
+int task_set_wakeup_gap(int gap) {
+  if (gap < -1 || gap > TASK_MAX_PRIO - TASK_MIN_PRIO) {
+    return -1;
+  }
+
+  wakeupGap = gap;
+  return 0;
+}
+
+void preempt_disable() { executingTask->preempt_count++; }
+
+int preempt_enable() {
+  if (executingTask->preempt_count <= 0) {
+    return -1;
+  }
+
+  executingTask->preempt_count--;
+  __preempt_resched();
+  return 0;
+}
+
+int task_set_periodic(int period, int deadline, int budget) {
+  if (period == 0 && deadline == 0 && budget == 0) {
+    executingTask->rt = (task_rt_t){0};
+    return 0;
+  }
+
+  if (period <= 0 || deadline <= 0 || deadline > period || budget <= 0
+      || budget > deadline) {
+    log_debug("invalid periodic parameters (%d, %d, %d)", period, deadline,
+              budget);
+    return -1;
+  }
+
+  // The first job is released now, and the counters start again
+  bkl_spinlock();
+  executingTask->rt = (task_rt_t){0};
+  executingTask->rt.period = (unsigned int)period;
+  executingTask->rt.deadline = (unsigned int)deadline;
+  executingTask->rt.budget = (unsigned int)budget;
+  executingTask->rt.release = totalSysTime;
+  executingTask->rt.abs_deadline = totalSysTime + (unsigned int)deadline;
+  bkl_unlock();
+  return 0;
+}
+
+int task_wait_period() {
+  if (!executingTask->rt.period) {
+    log_debug("task(%d) is not periodic", executingTask->tid);
+    return -1;
+  }
+
+  bkl_spinlock();
+  __rt_check_miss(executingTask);
+  executingTask->rt.stats.jobs++;
+  __rt_next_job(executingTask);
+
+  // A job that ended late already has the next one released
+  if (!__time_passed(executingTask->rt.release)) {
+    __sleep_until(executingTask->rt.release);
+  } else {
+    bkl_unlock();
+  }
+
+  return 0;
+}
+
+int task_rt_stats(const task_t *task, task_rt_stats_t *stats) {
+  if (stats == NULL) {
+    return -1;
+  }
+
+  if (task == NULL) {
+    task = executingTask;
+  }
+
+  if (!task->rt.period) {
+    return -1;
+  }
+
+  *stats = task->rt.stats;
+  return 0;
+}
+
+//=============================================================================
+// Software Timer Management
+//=============================================================================
+
+int ppos_timer_create(ppos_timer_t *timer, int delay, int period,
+                      void (*callback)(void *), void *arg) {
+  if (timer == NULL || callback == NULL || delay < 0 || period < 0) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  if (__timer_armed(timer)) {
+    bkl_unlock();
+    log_debug("timer is already armed");
+    return -1;
+  }
+
+  timer->expire = totalSysTime + (unsigned int)delay;
+  timer->period = (unsigned int)period;
+  timer->callback = callback;
+  timer->arg = arg;
+  timer->num_fired = 0;
+  if (__timer_insert(timer) < 0) {
+    bkl_unlock();
+    return -1;
+  }
+  bkl_unlock();
+
+  return 0;
+}
+
+int ppos_timer_cancel(ppos_timer_t *timer) {
+  if (timer == NULL) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  if (!__timer_armed(timer)) {
+    bkl_unlock();
+    return -1;
+  }
+
+  __timer_remove(timer);
+  bkl_unlock();
+  return 0;
 }
 
 //=============================================================================
-// General Public Functions
+// CPU Budget Management
 //=============================================================================
 
-void ppos_init() {
-  // Removes the virtual buffer of the output
-  // https://en.cppreference.com/w/c/io/setvbuf
-  (void)setvbuf(stdout, 0, _IONBF, 0);
+int cpu_budget_init(cpu_budget_t *budget, int runtime, int period) {
+  if (budget == NULL || runtime <= 0 || period <= 0 || runtime > period) {
+    return -1;
+  }
 
-  log_set(stderr, 0, LOG_FATAL);
+  budget->runtime = (unsigned int)runtime;
+  budget->period = (unsigned int)period;
+  budget->used = 0;
+  budget->replenish = totalSysTime + (unsigned int)period;
+  budget->num_tasks = 0;
+  budget->num_depleted = 0;
+  budget->num_throttles = 0;
+  return 0;
+}
 
-  __ppos_init_ready_queue();
-  __ppos_init_sleep_queue();
-  __ppos_init_main_task();
-  __ppos_init_disp_task();
-  __ppos_init_timer();
+int cpu_budget_attach(cpu_budget_t *budget, task_t *task) {
+  if (task == NULL) {
+    task = executingTask;
+  }
+
+  if (task->type == SYSTEM) {
+    return -1;
+  }
+
+  // Counted in the group from the next tick
+  bkl_spinlock();
+  if (task->cpu_budget) {
+    task->cpu_budget->num_tasks--;
+  }
+
+  task->cpu_budget = budget;
+  if (budget) {
+    budget->num_tasks++;
+  }
+  bkl_unlock();
+
+  return 0;
 }
 
-unsigned int systime() { return totalSysTime; }
+int cpu_budget_destroy(cpu_budget_t *budget) {
+  if (budget == NULL || budget->num_tasks > 0) {
+    return -1;
+  }
+
+  budget->runtime = 0;
+  budget->period = 0;
+  return 0;
+}
 
 //=============================================================================
-// Task Public Management
+// Wait Order Management
 //=============================================================================
 
-int task_init(task_t *task, void (*start_routine)(void *), void *arg) {
-  static int threadCount = 0;
+int wait_order_insert(task_t **queue, wait_order_t *order, task_t *task) {
+  if (order == NULL) {
+    return queue_append((queue_t **)queue, (queue_t *)task);
+  }
 
-  if (task == NULL) {
-    log_error("received a task == NULL");
-    return -1;
+  int level = task->initial_priority - TASK_MIN_PRIO;
+  unsigned long long above = order->map & ((2ULL << level) - 1);
+
+  int ret = 0;
+  if (above) {
+    // Appending before the task that follows the last one of the closest level
+    // with a priority as high inserts the task right after it
+    task_t *next = order->tails[63 - __builtin_clzll(above)]->next;
+    ret = queue_append((queue_t **)&next, (queue_t *)task);
+  } else {
+    // Every waiting task has a lower priority, so the task is the new head
+    ret = queue_append((queue_t **)queue, (queue_t *)task);
+    *queue = task;
   }
 
-  if (threadCount != MAIN_TASK && start_routine == NULL) {
-    log_error("received a start_routine == NULL");
-    return -1;
+  if (ret < 0) {
+    return ret;
   }
 
-  task->next = NULL;
-  task->prev = NULL;
-  task->tid = threadCount;
-  task->initial_priority = 0;
-  task->current_priority = 0;
-  task->type = USER;
-  task->quantum = TASK_QUANTUM;
-  task->total_time = 0;
-  task->current_time = 0;
-  task->sleep_time = 0;
-  task->num_calls = 0;
-  task->exit_result = 0;
-  task->waiting_queue = NULL;
-  task->waiting_result = 0;
+  task->wait_level = level;
+  task->wait_queue = queue;
+  task->wait_order = order;
+  order->tails[level] = task;
+  order->map |= 1ULL << level;
+  return 0;
+}
 
-  if (threadCount == MAIN_TASK) {
-    task->state = TASK_EXEC;
-    task->stack = NULL; // Main task does not need to allocate a stack
-    getcontext(&(task->context));
-  } else {
-    task->state = TASK_READY;
+int wait_order_remove(task_t **queue, wait_order_t *order, task_t *task) {
+  if (order && order->tails[task->wait_level] == task) {
+    int level = task->wait_level;
+    task_t *prev = task->prev;
 
-    // Initialize the context structure and its stack
-    getcontext(&(task->context));
-    char *stack = malloc((size_t)STACKSIZE);
-    if (stack) {
-      task->context.uc_stack.ss_sp = stack;
-      task->context.uc_stack.ss_size = (size_t)STACKSIZE;
-      task->context.uc_stack.ss_flags = 0;
-      task->context.uc_link = 0;
+    if (task != *queue && prev->wait_level == level) {
+      order->tails[level] = prev;
     } else {
-      log_error("stack could not be allocated");
-      return -1;
-    }
-    makecontext(&(task->context), (void *)start_routine, 1, arg);
-
-    if (task_manager_insert(readyQueue, task) < 0) {
-      log_debug("task(%d) could not be appended in the ready queue", task->tid);
-      return -1;
+      order->tails[level] = NULL;
+      order->map &= ~(1ULL << level);
     }
   }
 
-  threadCount++;
-  return 0;
+  task->wait_queue = NULL;
+  task->wait_order = NULL;
+  return queue_remove((queue_t **)queue, (queue_t *)task);
 }
 
-int task_switch(task_t *task) {
-  if (task == NULL) {
-    log_debug("received task == NULL");
+int wait_order_set(wait_order_t **order, const task_t *queue,
+                   wait_policy policy) {
+  // The tasks already waiting were not inserted in the levels
+  if (queue) {
     return -1;
   }
 
-  log_debug("(%d)->(%d)", executingTask->tid, task->tid);
-  task->num_calls++;
-
-  if (task_manager_remove(readyQueue, task) < 0) {
-    log_debug("could not remove task(%d) from ready queue", task->tid);
+  switch (policy) {
+  case WAIT_FIFO:
+    free(*order);
+    *order = NULL;
+    return 0;
+  case WAIT_PRIO:
+    if (*order == NULL) {
+      *order = calloc(1, sizeof(wait_order_t));
+    }
+    return *order ? 0 : -1;
+  default:
     return -1;
   }
+}
 
-  if (task_manager_insert(readyQueue, executingTask) < 0) {
-    log_debug("could not insert task(%d) into ready queue", executingTask->tid);
+//=============================================================================
+// Mutex Public Management
+//=============================================================================
+
+int mutex_init(mutex_t *mutex) {
+  if (mutex == NULL) {
     return -1;
   }
 
-  task_t *temp = executingTask;
-  executingTask = task;
-  task->state = TASK_EXEC;
-  temp->state = TASK_READY;
-
-  swapcontext(&(temp->context), &(executingTask->context));
+  mutex->lock = 0;
+  mutex->owner = NULL;
+  mutex->queue = NULL;
+  mutex->order = NULL;
+  mutex->next_held = NULL;
+  mutex->num_acquires = 0;
+  mutex->spin_limit = SPIN_LIMIT;
+  mutex->hold_avg = 0;
+  mutex->hold_start = 0;
+  mutex->num_spins = 0;
+  mutex->num_spin_acquires = 0;
+  mutex->num_suspends = 0;
+  mutex->pending = 0;
+  mutex->next_pending = NULL;
   return 0;
 }
 
-void task_exit(int exit_code) {
-  log_debug("task(%d)", executingTask->tid);
-  executingTask->exit_result = exit_code;
-  __context_swap_dispatcher(TASK_FINISH);
-}
+int mutex_destroy(mutex_t *mutex) {
+  if (mutex == NULL || mutex->lock < 0) {
+    return -1;
+  }
 
-int task_id() {
-  log_debug("%d", executingTask->tid);
-  return executingTask->tid;
-}
+  bkl_spinlock();
+  task_t *owner = mutex->owner;
+  if (owner) {
+    __mutex_release(mutex);
+  }
 
-void task_yield() {
-  log_debug("task(%d)", executingTask->tid);
-  __context_swap_dispatcher(TASK_READY);
+  __mutex_undefer(mutex);
+  mutex->lock = -1;
+  task_t *aux = mutex->queue;
+  if (aux) {
+    do {
+      aux->waiting_mutex = NULL;
+      aux = aux->next;
+    } while (aux != mutex->queue);
+
+    task_awake_all(&(mutex->queue));
+  }
+
+  free(mutex->order);
+  mutex->order = NULL;
+
+  if (owner) {
+    __task_reprio(owner, __mutex_inherited_prio(owner));
+  }
+  bkl_unlock();
+  return 0;
 }
 
-int task_getprio(const task_t *const task) {
-  if (task == NULL) {
-    return executingTask->initial_priority;
+int mutex_lock(mutex_t *mutex) {
+  if (mutex == NULL || mutex->lock < 0) {
+    return -1;
   }
 
-  return task->initial_priority;
-}
+  if (mutex->owner == executingTask) {
+    log_error("task(%d) already holds the mutex", executingTask->tid);
+    return -1;
+  }
 
-int task_setprio(task_t *task, int prio) {
-  if (prio > TASK_MAX_PRIO || prio < TASK_MIN_PRIO) {
+  bkl_spinlock();
+  if (!mutex->lock) {
+    __mutex_acquire(mutex, executingTask);
+    bkl_unlock();
+    return 0;
+  }
+  bkl_unlock();
+
+  if (__mutex_spin(mutex) == 0) {
+    return 0;
+  }
+
+  if (mutex->lock < 0) {
     return -1;
   }
 
-  task_t *aux = NULL;
-  if (task == NULL) {
-    aux = executingTask;
-  } else {
-    aux = task;
+  bkl_spinlock();
+  if (!mutex->lock) {
+    __mutex_acquire(mutex, executingTask);
+    bkl_unlock();
+    return 0;
   }
 
-  int diffPriority = aux->initial_priority - aux->current_priority;
-  aux->current_priority = prio - diffPriority;
-  aux->initial_priority = prio;
+  mutex->num_suspends++;
+  executingTask->waiting_mutex = mutex;
+  __mutex_boost(mutex, executingTask->initial_priority);
 
-  // Reinsert the task into the queue with its new priority
-  if (aux != executingTask) {
-    if (task_manager_remove(readyQueue, aux) < 0) {
-      log_debug("could not remove task(%d) from ready queue", aux->tid);
-      return -1;
-    }
+  // When awakened the mutex was already handed to this task, unless it was
+  // destroyed while waiting. The lock is kept while suspending, so the mutex
+  // is not handed in between
+  task_suspend_order(&(mutex->queue), mutex->order);
 
-    if (task_manager_insert(readyQueue, aux) < 0) {
-      log_debug("could not insert task(%d) into ready queue", aux->tid);
-      return -1;
-    }
+  if (mutex->lock < 0) {
+    return -1;
   }
 
   return 0;
 }
 
-int task_wait(task_t *task) {
-  if (task == NULL) {
-    log_error("receive a NULL task");
+int mutex_spin(mutex_t *mutex, int limit) {
+  if (mutex == NULL || mutex->lock < 0 || limit < 0) {
     return -1;
   }
 
-  if (task->state == TASK_FINISH) {
-    log_error("task(%d) already finished", task->tid);
+  mutex->spin_limit = limit;
+  return 0;
+}
+
+int mutex_setorder(mutex_t *mutex, wait_policy policy) {
+  if (mutex == NULL || mutex->lock < 0) {
     return -1;
   }
 
-  log_debug("task(%d) waiting task(%d)", executingTask->tid, task->tid);
-  task_suspend(&(task->waiting_queue));
-  return executingTask->waiting_result;
+  bkl_spinlock();
+  int ret = wait_order_set(&(mutex->order), mutex->queue, policy);
+  bkl_unlock();
+  return ret;
 }
 
-void task_suspend(task_t **queue) {
-  log_debug("suspending task(%d)", executingTask->tid);
+int mutex_unlock(mutex_t *mutex) {
+  if (mutex == NULL || mutex->lock < 0) {
+    return -1;
+  }
 
-  if (queue_append((queue_t **)queue, (queue_t *)executingTask) < 0) {
-    log_error("could not add task(%d) to the suspend queue",
-              executingTask->tid);
-    exit(1);
+  if (mutex->owner != executingTask) {
+    log_error("task(%d) does not hold the mutex", executingTask->tid);
+    return -1;
   }
 
-  numSuspedingTasks++;
-  __context_swap_dispatcher(TASK_SUSPENDED);
+  bkl_spinlock();
+  __mutex_unlock(mutex);
+  bkl_unlock();
+  return 0;
 }
 
-void task_awake(task_t *task, task_t **queue) {
-  if (task == NULL) {
-    log_error("received a NULL task");
-    exit(1);
-  }
+//=============================================================================
+// Condition Variable Public Management
+//=============================================================================
 
-  if (queue == NULL) {
-    log_error("received a NULL queue");
-    exit(1);
+int cond_init(cond_t *cond) {
+  if (cond == NULL) {
+    return -1;
   }
 
-  if (queue_remove((queue_t **)queue, (queue_t *)task) < 0) {
-    log_error("could not awake task(%d)", task->tid);
-    exit(1);
-  }
+  cond->queue = NULL;
+  cond->mutex = NULL;
+  cond->state = COND_INITALIZED;
+  return 0;
+}
 
-  task->state = TASK_READY;
-  if (task_manager_insert(readyQueue, task) < 0) {
-    log_error("failed to insert waiting task(%d) in ready queue", task->tid);
-    exit(1);
+int cond_destroy(cond_t *cond) {
+  if (cond == NULL || cond->state == COND_FINISHED) {
+    return -1;
   }
 
-  numSuspedingTasks--;
+  bkl_spinlock();
+  cond->state = COND_FINISHED;
+  while (cond->queue) {
+    __cond_morph(cond, 0);
+  }
+  bkl_unlock();
+  return 0;
 }
 
-void task_sleep(int time) {
-  log_debug("sleeping task(%d)", executingTask->tid);
-  if (time < 0) {
-    log_debug("time passed is negative");
-    return;
+int cond_wait(cond_t *cond, mutex_t *mutex) {
+  if (cond == NULL || cond->state == COND_FINISHED) {
+    return -1;
   }
 
-  executingTask->sleep_time = (unsigned int)time + totalSysTime;
+  if (mutex == NULL || mutex->lock < 0 || mutex->owner != executingTask) {
+    log_error("task(%d) does not hold the mutex", executingTask->tid);
+    return -1;
+  }
 
-  if (task_manager_insert(sleepQueue, executingTask) < 0) {
-    log_error("could not add task(%d) to the suspend queue",
+  if (cond->queue && cond->mutex != mutex) {
+    log_error("task(%d) waiting with a different mutex", executingTask->tid);
+    return -1;
+  }
+
+  bkl_spinlock();
+  cond->mutex = mutex;
+  if (queue_append((queue_t **)&(cond->queue), (queue_t *)executingTask) < 0) {
+    log_error("could not add task(%d) to the condition queue",
               executingTask->tid);
     exit(1);
   }
 
   numSuspedingTasks++;
-  __context_swap_dispatcher(TASK_SUSPENDED);
-}
+  __mutex_unlock(mutex);
 
-//=============================================================================
-// Mutex Public Management
-//=============================================================================
+  // When awakened the mutex was already handed to this task, unless it was
+  // destroyed while waiting
+  __context_swap_dispatcher(TASK_SUSPENDED);
 
-int mutex_init(mutex_t *mutex) {
-  if (mutex == NULL) {
+  if (mutex->lock < 0) {
     return -1;
   }
 
-  mutex->lock = 0;
-  return 0;
-}
-
-int mutex_destroy(mutex_t *mutex) {
-  if (mutex == NULL || mutex->lock < 0) {
+  // A task signaled before the destruction got its wakeup, otherwise it returns
+  // with an error and does not keep the mutex
+  if (!executingTask->cond_signaled) {
+    mutex_unlock(mutex);
     return -1;
   }
 
-  mutex->lock = -1;
-  return -1;
+  return 0;
 }
 
-int mutex_lock(mutex_t *mutex) {
-  if (mutex == NULL || mutex->lock < 0) {
+int cond_signal(cond_t *cond) {
+  if (cond == NULL || cond->state == COND_FINISHED) {
     return -1;
   }
 
-  int lock = mutex->lock;
-  mutex->lock = 1;
-  return lock;
+  bkl_spinlock();
+  if (cond->queue) {
+    __cond_morph(cond, 1);
+  }
+  bkl_unlock();
+  return 0;
 }
 
-int mutex_unlock(mutex_t *mutex) {
-  if (mutex == NULL || mutex->lock < 0) {
+int cond_broadcast(cond_t *cond) {
+  if (cond == NULL || cond->state == COND_FINISHED) {
     return -1;
   }
 
-  int lock = mutex->lock;
-  mutex->lock = 0;
-  return lock;
-}
\ No newline at end of file
+  bkl_spinlock();
+  while (cond->queue) {
+    __cond_morph(cond, 1);
+  }
+  bkl_unlock();
+  return 0;
+}
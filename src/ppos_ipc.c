@@ -9,14 +9,181 @@
  * License: BSD 2
  */
 
+#include "lib/queue.h"
 #include "ppos.h"
 #include "ppos_bkl.h"
 #include "ppos_data.h"
+#include "ppos_ipc.h"
 
 #include <stdlib.h>
 #include <string.h>
 
-#define bkl_spinlock() while (bkl_lock())
+// Semaphores released while there were tasks waiting for them
+static semaphore_t *pendingSems = NULL;
+
+//=============================================================================
+// Semaphore Private Functions
+//=============================================================================
+
+/**
+ * @brief Starts measuring the hold time of the unit just acquired.
+ *
+ * @param sem Pointer for the semaphore
+ */
+static void __sem_hold(semaphore_t *sem) {
+  if (sem->num_acquires % SPIN_HOLD_SAMPLE == 0) {
+    sem->hold_start = systime_ns();
+  }
+}
+
+/**
+ * @brief Checks if the executing task is the next one to get units.
+ *
+ * The units belong first to the waiting tasks, even the ones already handed to
+ * them that the dispatcher did not give yet, so the task is only the next one
+ * if there is no waiting task, or if it would be placed before all of them.
+ *
+ * @param sem Pointer for the semaphore
+ *
+ * @return 1 if the task can take the units available, or 0 otherwise.
+ */
+static int __sem_first(semaphore_t *sem) {
+  return sem->queue == NULL
+         || (sem->order
+             && task_self()->initial_priority < sem->queue->initial_priority);
+}
+
+/**
+ * @brief Takes units of the semaphore, if there are enough available and no
+ * waiting task comes first.
+ *
+ * @param sem Pointer for the semaphore
+ * @param n Number of units
+ *
+ * @return 0 if the units were taken, and -1 otherwise.
+ */
+static int __sem_trydown(semaphore_t *sem, int n) {
+  bkl_spinlock();
+  if (sem->lock >= n && __sem_first(sem)) {
+    sem->lock -= n;
+    __sem_hold(sem);
+    bkl_unlock();
+    return 0;
+  }
+  bkl_unlock();
+
+  return -1;
+}
+
+/**
+ * @brief Hands the available units to the first tasks waiting for them.
+ *
+ * The tasks are served in order, while there are enough units for the first
+ * one, and all of them are awakened at once. The awakened tasks already own
+ * their units, so they do not need to compete for them again when they get to
+ * execute.
+ *
+ * @param sem Pointer for the semaphore
+ */
+static void __sem_give(semaphore_t *sem) {
+  task_t *ready = NULL;
+
+  while (sem->queue && sem->lock >= sem->queue->sem_units) {
+    task_t *task = sem->queue;
+    sem->lock -= task->sem_units;
+    sem->num_wakeups++;
+
+    wait_order_remove(&(sem->queue), sem->order, task);
+    queue_append((queue_t **)&ready, (queue_t *)task);
+  }
+
+  if (ready) {
+    __sem_hold(sem);
+    task_awake_all(&ready);
+  }
+}
+
+/**
+ * @brief Marks the semaphore to hand its units to the waiting tasks.
+ *
+ * @param sem Pointer for the semaphore
+ */
+static void __sem_defer(semaphore_t *sem) {
+  if (sem->pending) {
+    return;
+  }
+
+  sem->pending = 1;
+  sem->next_pending = pendingSems;
+  pendingSems = sem;
+}
+
+/**
+ * @brief Removes the semaphore of the list of semaphores with units to hand.
+ *
+ * @param sem Pointer for the semaphore
+ */
+static void __sem_undefer(semaphore_t *sem) {
+  semaphore_t **aux = &pendingSems;
+  while (*aux && *aux != sem) {
+    aux = &((*aux)->next_pending);
+  }
+
+  if (*aux) {
+    *aux = sem->next_pending;
+  }
+
+  sem->pending = 0;
+  sem->next_pending = NULL;
+}
+
+/**
+ * @brief Awakes the tasks selecting this semaphore.
+ *
+ * @param sem Pointer for the semaphore
+ */
+static void __sem_notify(semaphore_t *sem) {
+  for (select_t *aux = sem->watchers; aux; aux = aux->next_watch) {
+    if (*(aux->waiting)) {
+      task_awake(*(aux->waiting), aux->waiting);
+    }
+  }
+}
+
+/**
+ * @brief Yields waiting for units of the semaphore.
+ *
+ * The task only yields if the units are usually held for a short time, and if
+ * there is no task suspended waiting for them, otherwise it is better to
+ * suspend right away.
+ *
+ * @param sem Pointer for the semaphore
+ * @param n Number of units
+ *
+ * @return 0 if the units were taken while yielding, and -1 otherwise.
+ */
+static int __sem_spin(semaphore_t *sem, int n) {
+  if (sem->hold_avg > SPIN_MAX_HOLD) {
+    return -1;
+  }
+
+  for (int i = 0; i < sem->spin_limit && sem->state != SEM_FINISHED; i++) {
+    // The units are handed to the suspended tasks first
+    if (sem->queue) {
+      return -1;
+    }
+
+    sem->num_spins++;
+    task_yield();
+
+    if (__sem_trydown(sem, n) == 0) {
+      sem->num_spin_acquires++;
+      return 0;
+    }
+  }
+
+  return -1;
+}
 
 //=============================================================================
 // Semaphore Functions
@@ -27,237 +194,1497 @@ int sem_init(semaphore_t *sem, int value) {
     return -1;
   }
 
-  if (sem->state != SEM_CREATED) {
+  if (sem->state != SEM_CREATED) {
+    return -1;
+  }
+
+  sem->state = SEM_INITALIZED;
+  sem->lock = value;
+  sem->queue = NULL;
+  sem->order = NULL;
+  sem->num_acquires = 0;
+  sem->num_suspends = 0;
+  sem->num_wakeups = 0;
+  sem->spin_limit = SPIN_LIMIT;
+  sem->hold_avg = 0;
+  sem->hold_start = 0;
+  sem->num_spins = 0;
+  sem->num_spin_acquires = 0;
+  sem->pending = 0;
+  sem->next_pending = NULL;
+  sem->watchers = NULL;
+  return 0;
+}
+
+int sem_destroy(semaphore_t *sem) {
+  if (sem == NULL) {
+    return -1;
+  }
+
+  if (sem->state == SEM_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  sem->state = SEM_FINISHED;
+  __sem_undefer(sem);
+  task_awake_all(&(sem->queue));
+  __sem_notify(sem);
+  free(sem->order);
+  sem->order = NULL;
+  bkl_unlock();
+  return 0;
+}
+
+int sem_setorder(semaphore_t *sem, wait_policy policy) {
+  if (sem == NULL || sem->state != SEM_INITALIZED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  int ret = wait_order_set(&(sem->order), sem->queue, policy);
+  bkl_unlock();
+  return ret;
+}
+
+int sem_up(semaphore_t *sem) { return sem_up_n(sem, 1); }
+
+int sem_up_n(semaphore_t *sem, int n) {
+  if (sem == NULL || n <= 0) {
+    return -1;
+  }
+
+  if (sem->state == SEM_FINISHED) {
+    return -1;
+  }
+
+  if (sem->hold_start) {
+    unsigned long long hold = systime_ns() - sem->hold_start;
+    sem->hold_avg =
+      sem->hold_avg - sem->hold_avg / SPIN_HOLD_WEIGHT + hold / SPIN_HOLD_WEIGHT;
+    sem->hold_start = 0;
+  }
+
+  bkl_spinlock();
+  sem->lock += n;
+
+  // A waiter more important than this task gets the units right away, so this
+  // task can not take them back. Otherwise the units are handed to the first
+  // waiters once this task leaves the processor.
+  if (sem->queue && sem->lock >= sem->queue->sem_units) {
+    if (sem->queue->initial_priority < task_getprio(NULL)) {
+      __sem_give(sem);
+    } else {
+      __sem_defer(sem);
+    }
+  }
+
+  // The selecting tasks check again once the waiters got their units, which
+  // for a deferred handoff is when it is done
+  if (sem->watchers && !sem->pending) {
+    __sem_notify(sem);
+  }
+  bkl_unlock();
+  return 0;
+}
+
+int sem_down(semaphore_t *sem) { return sem_down_n(sem, 1); }
+
+int sem_down_n(semaphore_t *sem, int n) {
+  if (sem == NULL || n <= 0) {
+    return -1;
+  }
+
+  if (sem->state == SEM_FINISHED) {
+    return -1;
+  }
+
+  sem->num_acquires++;
+  if (__sem_trydown(sem, n) == 0 || __sem_spin(sem, n) == 0) {
+    return 0;
+  }
+
+  if (sem->state == SEM_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  if (sem->lock >= n && __sem_first(sem)) {
+    sem->lock -= n;
+    __sem_hold(sem);
+    bkl_unlock();
+    return 0;
+  }
+
+  sem->num_suspends++;
+  task_self()->sem_units = n;
+
+  // When awakened the units already belong to this task, unless the semaphore
+  // was destroyed while waiting. The lock is kept while suspending, so no unit
+  // is handed in between
+  task_suspend_order(&(sem->queue), sem->order);
+
+  if (sem->state == SEM_FINISHED) {
+    return -1;
+  }
+
+  return 0;
+}
+
+int sem_spin(semaphore_t *sem, int limit) {
+  if (sem == NULL || sem->state == SEM_FINISHED || limit < 0) {
+    return -1;
+  }
+
+  sem->spin_limit = limit;
+  return 0;
+}
+
+void sem_handoff() {
+  while (pendingSems) {
+    semaphore_t *sem = pendingSems;
+    pendingSems = sem->next_pending;
+    sem->pending = 0;
+    sem->next_pending = NULL;
+
+    __sem_give(sem);
+    if (sem->watchers) {
+      __sem_notify(sem);
+    }
+  }
+}
+
+//=============================================================================
+// Reader-Writer Lock Private Functions
+//=============================================================================
+
+/**
+ * @brief Hands the lock to every waiting reader at once.
+ *
+ * @param rwlock Pointer for the lock
+ */
+static void __rwlock_wake_readers(rwlock_t *rwlock) {
+  rwlock->readers += task_awake_all(&(rwlock->readers_queue));
+}
+
+/**
+ * @brief Hands the lock to the first waiting writer.
+ *
+ * @param rwlock Pointer for the lock
+ */
+static void __rwlock_wake_writer(rwlock_t *rwlock) {
+  rwlock->writer = 1;
+  task_awake(rwlock->writers_queue, &(rwlock->writers_queue));
+}
+
+/**
+ * @brief Hands the free lock to the waiting tasks.
+ *
+ * The awakened tasks already hold the lock, so they do not need to compete
+ * for it again when they get to execute.
+ *
+ * @param rwlock Pointer for the lock
+ */
+static void __rwlock_handoff(rwlock_t *rwlock) {
+  if (rwlock->writer || rwlock->readers) {
+    return;
+  }
+
+  if (rwlock->pref == RW_PREFER_WRITERS) {
+    if (rwlock->writers_queue) {
+      __rwlock_wake_writer(rwlock);
+    } else {
+      __rwlock_wake_readers(rwlock);
+    }
+  } else {
+    if (rwlock->readers_queue) {
+      __rwlock_wake_readers(rwlock);
+    } else if (rwlock->writers_queue) {
+      __rwlock_wake_writer(rwlock);
+    }
+  }
+}
+
+//=============================================================================
+// Reader-Writer Lock Functions
+//=============================================================================
+
+int rwlock_init(rwlock_t *rwlock, rwlock_pref pref) {
+  if (rwlock == NULL) {
+    return -1;
+  }
+
+  if (pref != RW_PREFER_READERS && pref != RW_PREFER_WRITERS) {
+    return -1;
+  }
+
+  rwlock->readers = 0;
+  rwlock->writer = 0;
+  rwlock->pref = pref;
+  rwlock->state = RW_INITALIZED;
+  rwlock->readers_queue = NULL;
+  rwlock->writers_queue = NULL;
+  return 0;
+}
+
+int rwlock_destroy(rwlock_t *rwlock) {
+  if (rwlock == NULL || rwlock->state == RW_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  rwlock->state = RW_FINISHED;
+  task_awake_all(&(rwlock->readers_queue));
+  task_awake_all(&(rwlock->writers_queue));
+  bkl_unlock();
+  return 0;
+}
+
+int rwlock_rdlock(rwlock_t *rwlock) {
+  if (rwlock == NULL || rwlock->state == RW_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  if (!rwlock->writer
+      && (rwlock->pref == RW_PREFER_READERS || !rwlock->writers_queue)) {
+    rwlock->readers++;
+    bkl_unlock();
+    return 0;
+  }
+
+  task_suspend(&(rwlock->readers_queue));
+
+  if (rwlock->state == RW_FINISHED) {
+    return -1;
+  }
+
+  return 0;
+}
+
+int rwlock_wrlock(rwlock_t *rwlock) {
+  if (rwlock == NULL || rwlock->state == RW_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  if (!rwlock->writer && !rwlock->readers) {
+    rwlock->writer = 1;
+    bkl_unlock();
+    return 0;
+  }
+
+  task_suspend(&(rwlock->writers_queue));
+
+  if (rwlock->state == RW_FINISHED) {
+    return -1;
+  }
+
+  return 0;
+}
+
+int rwlock_unlock(rwlock_t *rwlock) {
+  if (rwlock == NULL || rwlock->state == RW_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  if (rwlock->writer) {
+    rwlock->writer = 0;
+  } else if (rwlock->readers > 0) {
+    rwlock->readers--;
+  } else {
+    bkl_unlock();
+    return -1;
+  }
+
+  __rwlock_handoff(rwlock);
+  bkl_unlock();
+  return 0;
+}
+
+//=============================================================================
+// Barrier Functions
+//=============================================================================
+
+int barrier_init(barrier_t *barrier, int num) {
+  if (barrier == NULL) {
+    return -1;
+  }
+
+  barrier->state = BAR_INITALIZED;
+  barrier->queue = NULL;
+  barrier->num_tasks = num;
+  return 0;
+}
+
+int barrier_destroy(barrier_t *barrier) {
+  if (barrier == NULL || barrier->state == BAR_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  barrier->state = BAR_FINISHED;
+  task_awake_all(&(barrier->queue));
+  bkl_unlock();
+  return 0;
+}
+
+int barrier_join(barrier_t *barrier) {
+  if (barrier == NULL || barrier->state == BAR_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  barrier->num_tasks--;
+
+  if (barrier->num_tasks <= 0) {
+    // Restores the count for the next use, including the last task
+    barrier->num_tasks += task_awake_all(&(barrier->queue)) + 1;
+    bkl_unlock();
+  } else {
+    task_suspend(&(barrier->queue));
+  }
+
+  if (barrier->state == BAR_FINISHED) {
+    return -1;
+  }
+
+  return 0;
+}
+
+//=============================================================================
+// Tree Barrier Private Functions
+//=============================================================================
+
+/**
+ * @brief Arrives in a node of the tree barrier.
+ *
+ * The last task to arrive carries the arrival to the parent node, and when
+ * released there, releases every task waiting in this node. The others wait
+ * until the sense of the node changes.
+ *
+ * @param barrier Pointer for the tree barrier
+ * @param node Pointer for the node where the task arrived
+ *
+ * @return 0 on success, and -1 if the barrier was destroyed.
+ */
+static int __tbarrier_arrive(tbarrier_t *barrier, tbarrier_node_t *node) {
+  bkl_spinlock();
+  int sense = !node->sense;
+  node->count--;
+
+  if (node->count > 0) {
+    while (barrier->state != BAR_FINISHED && node->sense != sense) {
+      task_suspend(&(node->queue));
+      bkl_spinlock();
+    }
+    bkl_unlock();
+
+    return barrier->state == BAR_FINISHED ? -1 : 0;
+  }
+
+  // The count is restored before leaving, since no task of this subtree can
+  // arrive again until the node is released
+  node->count = node->num;
+  bkl_unlock();
+
+  if (node->parent && __tbarrier_arrive(barrier, node->parent) < 0) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  node->sense = sense;
+  task_awake_all(&(node->queue));
+  bkl_unlock();
+  return 0;
+}
+
+//=============================================================================
+// Tree Barrier Functions
+//=============================================================================
+
+int tbarrier_init(tbarrier_t *barrier, int num) {
+  if (barrier == NULL || num <= 0) {
+    return -1;
+  }
+
+  // Counts the nodes of every level, from the leaves to the root
+  int num_nodes = 0;
+  int width = num;
+  do {
+    width = (width + TBARRIER_RADIX - 1) / TBARRIER_RADIX;
+    num_nodes += width;
+  } while (width > 1);
+
+  barrier->nodes = calloc(num_nodes, sizeof(tbarrier_node_t));
+  if (barrier->nodes == NULL) {
+    return -1;
+  }
+
+  // Each level receives the arrivals of the one below it
+  int children = num;
+  int level = 0;
+  while (level < num_nodes) {
+    width = (children + TBARRIER_RADIX - 1) / TBARRIER_RADIX;
+    for (int i = 0; i < width; i++) {
+      tbarrier_node_t *node = &(barrier->nodes[level + i]);
+      node->num = children - i * TBARRIER_RADIX;
+      if (node->num > TBARRIER_RADIX) {
+        node->num = TBARRIER_RADIX;
+      }
+
+      node->count = node->num;
+      node->sense = 0;
+      node->queue = NULL;
+      node->parent = width > 1
+                         ? &(barrier->nodes[level + width + i / TBARRIER_RADIX])
+                         : NULL;
+    }
+
+    level += width;
+    children = width;
+  }
+
+  barrier->num_tasks = num;
+  barrier->num_nodes = num_nodes;
+  barrier->state = BAR_INITALIZED;
+  return 0;
+}
+
+int tbarrier_destroy(tbarrier_t *barrier) {
+  if (barrier == NULL || barrier->state == BAR_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  barrier->state = BAR_FINISHED;
+  for (int i = 0; i < barrier->num_nodes; i++) {
+    task_awake_all(&(barrier->nodes[i].queue));
+  }
+  bkl_unlock();
+
+  free(barrier->nodes);
+  barrier->nodes = NULL;
+  return 0;
+}
+
+int tbarrier_join(tbarrier_t *barrier, int id) {
+  if (barrier == NULL || barrier->state == BAR_FINISHED) {
+    return -1;
+  }
+
+  if (id < 0 || id >= barrier->num_tasks) {
+    return -1;
+  }
+
+  return __tbarrier_arrive(barrier, &(barrier->nodes[id / TBARRIER_RADIX]));
+}
+
+//=============================================================================
+// Message Queue Private Functions
+//=============================================================================
+
+/**
+ * @brief Takes a free slot of the message queue.
+ *
+ * There is always a free slot, since the caller got a unit of sem_prod.
+ *
+ * @param queue Pointer for the message queue
+ *
+ * @return The index of the slot.
+ */
+static int __mqueue_alloc(mqueue_t *queue) {
+  bkl_spinlock();
+  int slot = queue->free_slot;
+  queue->free_slot = queue->links[slot];
+  bkl_unlock();
+  return slot;
+}
+
+/**
+ * @brief Gives back a slot of the message queue.
+ *
+ * @param queue Pointer for the message queue
+ * @param slot Index of the slot
+ */
+static void __mqueue_free(mqueue_t *queue, int slot) {
+  bkl_spinlock();
+  queue->links[slot] = queue->free_slot;
+  queue->free_slot = slot;
+  bkl_unlock();
+}
+
+/**
+ * @brief Appends the slot to the list of its priority.
+ *
+ * @param queue Pointer for the message queue
+ * @param slot Index of the slot with the message
+ * @param prio Priority of the message
+ */
+static void __mqueue_push(mqueue_t *queue, int slot, int prio) {
+  bkl_spinlock();
+  queue->links[slot] = -1;
+  if (queue->heads[prio] < 0) {
+    queue->heads[prio] = slot;
+  } else {
+    queue->links[queue->tails[prio]] = slot;
+  }
+
+  queue->tails[prio] = slot;
+  queue->prio_map |= 1U << prio;
+  queue->num_msgs++;
+  bkl_unlock();
+}
+
+/**
+ * @brief Removes the first slot of the highest priority with messages.
+ *
+ * There is always a message, since the caller got a unit of sem_cons.
+ *
+ * @param queue Pointer for the message queue
+ *
+ * @return The index of the slot.
+ */
+static int __mqueue_pop(mqueue_t *queue) {
+  bkl_spinlock();
+  int prio = __builtin_ctz(queue->prio_map);
+  int slot = queue->heads[prio];
+
+  queue->heads[prio] = queue->links[slot];
+  if (queue->heads[prio] < 0) {
+    queue->prio_map &= ~(1U << prio);
+  }
+
+  queue->num_msgs--;
+  bkl_unlock();
+  return slot;
+}
+
+//=============================================================================
+// Message Queue Functions
+//=============================================================================
+
+int mqueue_init(mqueue_t *queue, int max_msgs, int msg_size) {
+  return mqueue_init_prio(queue, max_msgs, msg_size, 1);
+}
+
+int mqueue_init_prio(mqueue_t *queue, int max_msgs, int msg_size,
+                     int num_prios) {
+  if (queue == NULL || max_msgs < 0) {
+    return -1;
+  }
+
+  if (num_prios <= 0 || num_prios > MQUEUE_MAX_PRIOS) {
+    return -1;
+  }
+
+  queue->state = MQE_INITALIZED;
+  queue->num_msgs = 0;
+  queue->max_msgs = max_msgs;
+  queue->msg_size = (size_t)msg_size;
+  queue->num_prios = num_prios;
+  queue->prio_map = 0;
+
+  // Allocated before the semaphores are initialized, so a failure leaves them
+  // free to be initialized again
+  queue->msgs = calloc((size_t)max_msgs, (size_t)msg_size);
+  queue->links = malloc(sizeof(int) * (size_t)max_msgs);
+  queue->heads = malloc(sizeof(int) * (size_t)num_prios);
+  queue->tails = malloc(sizeof(int) * (size_t)num_prios);
+  if ((max_msgs > 0 && (queue->msgs == NULL || queue->links == NULL))
+      || queue->heads == NULL || queue->tails == NULL) {
+    goto error;
+  }
+
+  if (sem_init(&(queue->sem_prod), max_msgs) < 0) {
+    goto error;
+  }
+
+  if (sem_init(&(queue->sem_cons), 0) < 0) {
+    goto error;
+  }
+
+  // Every slot starts in the free list
+  for (int i = 0; i < max_msgs; i++) {
+    queue->links[i] = i + 1 < max_msgs ? i + 1 : -1;
+  }
+  queue->free_slot = max_msgs > 0 ? 0 : -1;
+
+  for (int i = 0; i < num_prios; i++) {
+    queue->heads[i] = -1;
+    queue->tails[i] = -1;
+  }
+
+  return 0;
+error:
+  free(queue->msgs);
+  free(queue->links);
+  free(queue->heads);
+  free(queue->tails);
+  queue->msgs = NULL;
+  queue->links = NULL;
+  queue->heads = NULL;
+  queue->tails = NULL;
+  return -1;
+}
+
+int mqueue_send(mqueue_t *queue, void *msg) {
+  if (queue == NULL) {
+    return -1;
+  }
+
+  return mqueue_send_prio(queue, msg, queue->num_prios - 1);
+}
+
+int mqueue_send_prio(mqueue_t *queue, void *msg, int prio) {
+  if (queue == NULL || queue->state == MQE_FINISHED) {
+    goto error;
+  }
+
+  if (prio < 0 || prio >= queue->num_prios) {
+    goto error;
+  }
+
+  if (sem_down(&(queue->sem_prod)) < 0) {
+    goto error;
+  }
+
+  if (queue->state == MQE_FINISHED) {
+    goto error;
+  }
+
+  int slot = __mqueue_alloc(queue);
+  memcpy((char *)queue->msgs + ((size_t)slot * queue->msg_size), msg,
+         queue->msg_size);
+  __mqueue_push(queue, slot, prio);
+
+  if (sem_up(&(queue->sem_cons)) < 0) {
+    goto error;
+  }
+
+  return 0;
+error:
+  return -1;
+}
+
+int mqueue_recv(mqueue_t *queue, void *msg) {
+  if (queue == NULL || queue->state == MQE_FINISHED) {
+    goto error;
+  }
+
+  if (sem_down(&(queue->sem_cons)) < 0) {
+    goto error;
+  }
+
+  if (queue->state == MQE_FINISHED) {
+    goto error;
+  }
+
+  int slot = __mqueue_pop(queue);
+  memcpy(msg, (char *)queue->msgs + ((size_t)slot * queue->msg_size),
+         queue->msg_size);
+  __mqueue_free(queue, slot);
+
+  if (sem_up(&(queue->sem_prod)) < 0) {
+    goto error;
+  }
+
+  if (queue->state == MQE_FINISHED) {
+    goto error;
+  }
+
+  return 0;
+error:
+  return -1;
+}
+
+int mqueue_destroy(mqueue_t *queue) {
+  if (queue == NULL || queue->state == MQE_FINISHED) {
+    return -1;
+  }
+
+  queue->state = MQE_FINISHED;
+  free(queue->msgs);
+  free(queue->links);
+  free(queue->heads);
+  free(queue->tails);
+
+  if (sem_destroy(&(queue->sem_prod)) < 0) {
+    return -1;
+  }
+
+  if (sem_destroy(&(queue->sem_cons)) < 0) {
+    return -1;
+  }
+
+  return 0;
+}
+
+int mqueue_msgs(mqueue_t *queue) {
+  if (queue == NULL || queue->state == MQE_FINISHED) {
+    return -1;
+  }
+
+  return queue->num_msgs;
+}
+
+int mqueue_setorder(mqueue_t *queue, wait_policy policy) {
+  if (queue == NULL || queue->state != MQE_INITALIZED) {
+    return -1;
+  }
+
+  semaphore_t *prod = &(queue->sem_prod);
+  semaphore_t *cons = &(queue->sem_cons);
+  wait_policy prev = prod->order ? WAIT_PRIO : WAIT_FIFO;
+  int ret = -1;
+
+  // Both semaphores are checked before any of them changes, and the first one
+  // is rolled back if the second can not be changed, so both keep one order
+  bkl_spinlock();
+  if (cons->queue == NULL
+      && wait_order_set(&(prod->order), prod->queue, policy) == 0) {
+    ret = wait_order_set(&(cons->order), cons->queue, policy);
+    if (ret < 0) {
+      wait_order_set(&(prod->order), prod->queue, prev);
+    }
+  }
+  bkl_unlock();
+  return ret;
+}
+
+//=============================================================================
+// Channel Private Functions
+//=============================================================================
+
+// Size of the header with the length of each record
+#define CHAN_HEADER ((int)sizeof(int))
+
+// Length written in the header to skip the end of the buffer
+#define CHAN_SKIP (-1)
+
+/**
+ * @brief Copies bytes into the ring buffer, wrapping around its end.
+ *
+ * @param chan Pointer for the channel
+ * @param offset Offset in the buffer where the copy starts
+ * @param data Pointer for the bytes to be copied
+ * @param len Number of bytes
+ *
+ * @return Offset right after the copied bytes.
+ */
+static int __channel_write(channel_t *chan, int offset, const void *data,
+                           int len) {
+  int first = chan->size - offset < len ? chan->size - offset : len;
+  memcpy(chan->buffer + offset, data, (size_t)first);
+  memcpy(chan->buffer, (const char *)data + first, (size_t)(len - first));
+  return (offset + len) % chan->size;
+}
+
+/**
+ * @brief Copies bytes out of the ring buffer, wrapping around its end.
+ *
+ * @param chan Pointer for the channel
+ * @param offset Offset in the buffer where the copy starts
+ * @param data Pointer for where the bytes are copied
+ * @param len Number of bytes
+ *
+ * @return Offset right after the copied bytes.
+ */
+static int __channel_read(channel_t *chan, int offset, void *data, int len) {
+  int first = chan->size - offset < len ? chan->size - offset : len;
+  memcpy(data, chan->buffer + offset, (size_t)first);
+  memcpy((char *)data + first, chan->buffer, (size_t)(len - first));
+  return (offset + len) % chan->size;
+}
+
+/**
+ * @brief Calculates where a record fits in the channel.
+ *
+ * @param chan Pointer for the channel
+ * @param record Size of the record, header included
+ * @param skip Pointer that receives the number of bytes skipped at the end of
+ * the buffer before the record
+ *
+ * @return 0 if the record fits now, and -1 otherwise.
+ */
+static int __channel_fit(channel_t *chan, int record, int *skip) {
+  *skip = 0;
+
+  if (chan->mode == CHAN_SPLIT || chan->used == chan->size) {
+    return chan->used + record <= chan->size ? 0 : -1;
+  }
+
+  // The free space is contiguous when the records do not reach the end
+  if (chan->tail < chan->head) {
+    return record <= chan->head - chan->tail ? 0 : -1;
+  }
+
+  if (record <= chan->size - chan->tail) {
+    return 0;
+  }
+
+  *skip = chan->size - chan->tail;
+  return record <= chan->head ? 0 : -1;
+}
+
+/**
+ * @brief Skips the end of the buffer, if the next record was placed at the
+ * beginning.
+ *
+ * @param chan Pointer for the channel in CHAN_NOSPLIT mode with some record
+ */
+static void __channel_skip(channel_t *chan) {
+  int left = chan->size - chan->head;
+  int len = 0;
+
+  if (left >= CHAN_HEADER) {
+    memcpy(&len, chan->buffer + chan->head, sizeof(int));
+  }
+
+  if (left < CHAN_HEADER || len == CHAN_SKIP) {
+    chan->used -= left;
+    chan->head = 0;
+  }
+}
+
+//=============================================================================
+// Channel Functions
+//=============================================================================
+
+int channel_init(channel_t *chan, int size, channel_mode mode) {
+  if (chan == NULL || size <= CHAN_HEADER) {
+    return -1;
+  }
+
+  if (mode != CHAN_SPLIT && mode != CHAN_NOSPLIT) {
+    return -1;
+  }
+
+  chan->buffer = malloc((size_t)size);
+  if (chan->buffer == NULL) {
     return -1;
   }
 
-  sem->state = SEM_INITALIZED;
-  sem->lock = value;
+  chan->size = size;
+  chan->head = 0;
+  chan->tail = 0;
+  chan->used = 0;
+  chan->num_msgs = 0;
+  chan->mode = mode;
+  chan->state = CHAN_INITALIZED;
+  chan->senders = NULL;
+  chan->receivers = NULL;
   return 0;
 }
 
-int sem_destroy(semaphore_t *sem) {
-  if (sem == NULL) {
+int channel_send(channel_t *chan, void *msg, int len) {
+  if (chan == NULL || chan->state == CHAN_FINISHED) {
     return -1;
   }
 
-  if (sem->state == SEM_FINISHED) {
+  int record = CHAN_HEADER + len;
+  if (msg == NULL || len < 0 || record > chan->size) {
     return -1;
   }
 
+  int skip;
   bkl_spinlock();
-  while (sem->queue) {
-    task_awake(sem->queue, &(sem->queue));
+  while (__channel_fit(chan, record, &skip) < 0) {
+    task_suspend(&(chan->senders));
+    if (chan->state == CHAN_FINISHED) {
+      return -1;
+    }
+    bkl_spinlock();
   }
 
-  sem->state = SEM_FINISHED;
+  if (skip) {
+    if (skip >= CHAN_HEADER) {
+      int marker = CHAN_SKIP;
+      memcpy(chan->buffer + chan->tail, &marker, sizeof(int));
+    }
+
+    chan->used += skip;
+    chan->tail = 0;
+  }
+
+  chan->tail = __channel_write(chan, chan->tail, &len, CHAN_HEADER);
+  chan->tail = __channel_write(chan, chan->tail, msg, len);
+  chan->used += record;
+  chan->num_msgs++;
+
+  if (chan->receivers) {
+    task_awake(chan->receivers, &(chan->receivers));
+  }
   bkl_unlock();
   return 0;
 }
 
-int sem_up(semaphore_t *sem) {
-  if (sem == NULL) {
+int channel_recv(channel_t *chan, void *msg, int max) {
+  if (chan == NULL || chan->state == CHAN_FINISHED || msg == NULL) {
     return -1;
   }
 
-  if (sem->state == SEM_FINISHED) {
+  bkl_spinlock();
+  while (chan->num_msgs == 0) {
+    task_suspend(&(chan->receivers));
+    if (chan->state == CHAN_FINISHED) {
+      return -1;
+    }
+    bkl_spinlock();
+  }
+
+  if (chan->mode == CHAN_NOSPLIT) {
+    __channel_skip(chan);
+  }
+
+  int len;
+  int offset = __channel_read(chan, chan->head, &len, CHAN_HEADER);
+  if (len > max) {
+    bkl_unlock();
     return -1;
   }
 
-  if (sem->queue) {
-    task_awake(sem->queue, &(sem->queue));
+  chan->head = __channel_read(chan, offset, msg, len);
+  chan->used -= CHAN_HEADER + len;
+  chan->num_msgs--;
+
+  // An empty channel starts again from the beginning, keeping the free space
+  // contiguous
+  if (chan->used == 0) {
+    chan->head = 0;
+    chan->tail = 0;
+  }
+
+  // The space freed may fit the record of any of the senders
+  task_awake_all(&(chan->senders));
+  bkl_unlock();
+  return len;
+}
+
+int channel_destroy(channel_t *chan) {
+  if (chan == NULL || chan->state == CHAN_FINISHED) {
+    return -1;
   }
 
   bkl_spinlock();
-  sem->lock++;
+  chan->state = CHAN_FINISHED;
+  task_awake_all(&(chan->senders));
+  task_awake_all(&(chan->receivers));
   bkl_unlock();
+
+  free(chan->buffer);
+  chan->buffer = NULL;
   return 0;
 }
 
-int sem_down(semaphore_t *sem) {
-  if (sem == NULL) {
+int channel_msgs(channel_t *chan) {
+  if (chan == NULL || chan->state == CHAN_FINISHED) {
     return -1;
   }
 
-  if (sem->state == SEM_FINISHED) {
-    return -1;
+  return chan->num_msgs;
+}
+
+//=============================================================================
+// Broadcast Private Functions
+//=============================================================================
+
+/**
+ * @brief Checks if the ring has room for another message.
+ *
+ * @param bcast Pointer for the ring
+ *
+ * @return 1 if the oldest message was read by every subscriber, or if the
+ * messages can be dropped, and 0 otherwise.
+ */
+static int __bcast_room(bcast_t *bcast) {
+  if (bcast->policy == BCAST_DROP) {
+    return 1;
   }
 
-  while (!sem->lock && sem->state != SEM_FINISHED) {
-    task_suspend(&(sem->queue));
+  for (bcast_sub_t *aux = bcast->subs; aux; aux = aux->next) {
+    if (bcast->seq - aux->seq >= (unsigned long)bcast->max_msgs) {
+      return 0;
+    }
   }
 
-  bkl_spinlock();
-  sem->lock--;
-  bkl_unlock();
-  return 0;
+  return 1;
 }
 
 //=============================================================================
-// Barrier Functions
+// Broadcast Functions
 //=============================================================================
 
-int barrier_init(barrier_t *barrier, int num) {
-  if (barrier == NULL) {
+int bcast_init(bcast_t *bcast, int max_msgs, int msg_size,
+               bcast_policy policy) {
+  if (bcast == NULL || max_msgs <= 0 || msg_size < 0) {
     return -1;
   }
 
-  barrier->state = BAR_INITALIZED;
-  barrier->queue = NULL;
-  barrier->num_tasks = num;
+  if (policy != BCAST_BLOCK && policy != BCAST_DROP) {
+    return -1;
+  }
+
+  bcast->msgs = calloc((size_t)max_msgs, (size_t)msg_size);
+  if (bcast->msgs == NULL) {
+    return -1;
+  }
+
+  bcast->max_msgs = max_msgs;
+  bcast->msg_size = (size_t)msg_size;
+  bcast->seq = 0;
+  bcast->policy = policy;
+  bcast->state = BCAST_INITALIZED;
+  bcast->subs = NULL;
+  bcast->senders = NULL;
+  bcast->receivers = NULL;
   return 0;
 }
 
-int barrier_destroy(barrier_t *barrier) {
-  if (barrier == NULL || barrier->state == BAR_FINISHED) {
+int bcast_subscribe(bcast_t *bcast, bcast_sub_t *sub) {
+  if (bcast == NULL || bcast->state == BCAST_FINISHED || sub == NULL) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  sub->bcast = bcast;
+  sub->seq = bcast->seq;
+  sub->num_drops = 0;
+  sub->next = bcast->subs;
+  bcast->subs = sub;
+  bkl_unlock();
+  return 0;
+}
+
+int bcast_unsubscribe(bcast_sub_t *sub) {
+  if (sub == NULL || sub->bcast == NULL) {
     return -1;
   }
 
-  while (barrier->queue) {
-    task_awake(barrier->queue, &(barrier->queue));
+  bcast_t *bcast = sub->bcast;
+  bkl_spinlock();
+  bcast_sub_t **aux = &(bcast->subs);
+  while (*aux && *aux != sub) {
+    aux = &((*aux)->next);
+  }
+
+  if (*aux) {
+    *aux = sub->next;
   }
 
-  barrier->state = BAR_FINISHED;
+  sub->bcast = NULL;
+  sub->next = NULL;
+
+  // The subscriber may have been the slowest one
+  task_awake_all(&(bcast->senders));
+  bkl_unlock();
   return 0;
 }
 
-int barrier_join(barrier_t *barrier) {
-  if (barrier == NULL || barrier->state == BAR_FINISHED) {
+int bcast_send(bcast_t *bcast, void *msg) {
+  if (bcast == NULL || bcast->state == BCAST_FINISHED || msg == NULL) {
     return -1;
   }
 
   bkl_spinlock();
-  barrier->num_tasks--;
+  while (!__bcast_room(bcast)) {
+    task_suspend(&(bcast->senders));
+    if (bcast->state == BCAST_FINISHED) {
+      return -1;
+    }
+    bkl_spinlock();
+  }
+
+  size_t slot = bcast->seq % (unsigned long)bcast->max_msgs;
+  memcpy((char *)bcast->msgs + slot * bcast->msg_size, msg, bcast->msg_size);
+  bcast->seq++;
+
+  task_awake_all(&(bcast->receivers));
   bkl_unlock();
+  return 0;
+}
 
-  if (barrier->num_tasks <= 0) {
-    while (barrier->queue) {
-      task_awake(barrier->queue, &(barrier->queue));
-      barrier->num_tasks++;
+int bcast_recv(bcast_sub_t *sub, void *msg) {
+  if (sub == NULL || sub->bcast == NULL || msg == NULL) {
+    return -1;
+  }
+
+  bcast_t *bcast = sub->bcast;
+  if (bcast->state == BCAST_FINISHED) {
+    return -1;
+  }
+
+  bkl_spinlock();
+  while (sub->seq == bcast->seq) {
+    task_suspend(&(bcast->receivers));
+    if (bcast->state == BCAST_FINISHED) {
+      return -1;
     }
-  } else {
-    task_suspend(&(barrier->queue));
+    bkl_spinlock();
   }
 
-  if (barrier->state == BAR_FINISHED) {
+  // Only the last ring of messages is still available
+  unsigned long lag = bcast->seq - sub->seq;
+  if (lag > (unsigned long)bcast->max_msgs) {
+    sub->num_drops += lag - (unsigned long)bcast->max_msgs;
+    sub->seq = bcast->seq - (unsigned long)bcast->max_msgs;
+  }
+
+  size_t slot = sub->seq % (unsigned long)bcast->max_msgs;
+  memcpy(msg, (char *)bcast->msgs + slot * bcast->msg_size, bcast->msg_size);
+  sub->seq++;
+
+  // Only a subscriber a whole ring behind can be holding the senders
+  if (lag >= (unsigned long)bcast->max_msgs && bcast->senders) {
+    task_awake_all(&(bcast->senders));
+  }
+  bkl_unlock();
+  return 0;
+}
+
+int bcast_destroy(bcast_t *bcast) {
+  if (bcast == NULL || bcast->state == BCAST_FINISHED) {
     return -1;
   }
 
+  bkl_spinlock();
+  bcast->state = BCAST_FINISHED;
+  task_awake_all(&(bcast->senders));
+  task_awake_all(&(bcast->receivers));
+  bkl_unlock();
+
+  free(bcast->msgs);
+  bcast->msgs = NULL;
   return 0;
 }
 
 //=============================================================================
-// Message Queue Functions
+// Future Functions
 //=============================================================================
 
-int mqueue_init(mqueue_t *queue, int max_msgs, int msg_size) {
-  if (queue == NULL || max_msgs < 0) {
+int future_init(future_t *future) {
+  if (future == NULL) {
     return -1;
   }
 
-  queue->state = MQE_INITALIZED;
-  queue->index = 0;
-  queue->num_msgs = 0;
-  queue->max_msgs = max_msgs;
-  queue->msg_size = (size_t)msg_size;
+  future->value = NULL;
+  future->state = FUTURE_PENDING;
+  future->queue = NULL;
+  return 0;
+}
 
-  if (sem_init(&(queue->sem_prod), max_msgs) < 0) {
+int future_complete(future_t *future, void *value) {
+  if (future == NULL || future->state != FUTURE_PENDING) {
     return -1;
   }
 
-  if (sem_init(&(queue->sem_cons), 0) < 0) {
+  bkl_spinlock();
+  future->value = value;
+  future->state = FUTURE_DONE;
+  task_awake_all(&(future->queue));
+  bkl_unlock();
+  return 0;
+}
+
+int future_get(future_t *future, void **value) {
+  if (future == NULL) {
     return -1;
   }
 
-  queue->msgs = calloc((size_t)max_msgs, (size_t)msg_size);
+  bkl_spinlock();
+  while (future->state == FUTURE_PENDING) {
+    task_suspend(&(future->queue));
+    bkl_spinlock();
+  }
+  bkl_unlock();
+
+  if (future->state == FUTURE_FINISHED) {
+    return -1;
+  }
+
+  if (value) {
+    *value = future->value;
+  }
 
   return 0;
 }
 
-int mqueue_send(mqueue_t *queue, void *msg) {
-  if (queue == NULL || queue->state == MQE_FINISHED) {
-    goto error;
+int future_done(future_t *future) {
+  if (future == NULL || future->state == FUTURE_FINISHED) {
+    return -1;
   }
 
-  if (sem_down(&(queue->sem_prod)) < 0) {
-    goto error;
+  return future->state == FUTURE_DONE;
+}
+
+int future_destroy(future_t *future) {
+  if (future == NULL || future->state == FUTURE_FINISHED) {
+    return -1;
   }
 
-  if (queue->state == MQE_FINISHED) {
-    goto error;
+  bkl_spinlock();
+  future->state = FUTURE_FINISHED;
+  task_awake_all(&(future->queue));
+  bkl_unlock();
+  return 0;
+}
+
+//=============================================================================
+// Event Group Private Functions
+//=============================================================================
+
+/**
+ * @brief Checks if the bits satisfy the wait of a task.
+ *
+ * @param bits Bits set in the event group
+ * @param wanted Bits waited
+ * @param flags Flags of the wait
+ *
+ * @return 1 if the wait is satisfied, and 0 otherwise.
+ */
+static int __event_match(unsigned int bits, unsigned int wanted, int flags) {
+  if (flags & EVENT_ALL) {
+    return (bits & wanted) == wanted;
   }
 
-  memcpy((char *)queue->msgs + ((size_t)queue->index * queue->msg_size), msg,
-         queue->msg_size);
+  return (bits & wanted) != 0;
+}
 
-  queue->index = (queue->index + 1) % queue->max_msgs;
+//=============================================================================
+// Event Group Functions
+//=============================================================================
 
-  if (sem_up(&(queue->sem_cons)) < 0) {
-    goto error;
+int event_init(event_t *event, unsigned int bits) {
+  if (event == NULL) {
+    return -1;
   }
 
+  event->bits = bits;
+  event->state = EVENT_INITALIZED;
+  event->queue = NULL;
+  event->num_wakeups = 0;
   return 0;
-error:
-  return -1;
 }
 
-int mqueue_recv(mqueue_t *queue, void *msg) {
-  if (queue == NULL || queue->state == MQE_FINISHED) {
-    goto error;
+int event_set(event_t *event, unsigned int bits) {
+  if (event == NULL || event->state == EVENT_FINISHED) {
+    return -1;
   }
 
-  if (sem_down(&(queue->sem_cons)) < 0) {
-    goto error;
+  bkl_spinlock();
+  event->bits |= bits;
+
+  // Every waiting task is checked once, the satisfied ones are moved to the
+  // list awakened at once, and the other ones are kept in order
+  task_t *ready = NULL;
+  task_t *waiting = NULL;
+  unsigned int clear = 0;
+  while (event->queue) {
+    task_t *task = event->queue;
+    queue_remove((queue_t **)&(event->queue), (queue_t *)task);
+
+    if (__event_match(event->bits, task->event_bits, task->event_flags)) {
+      if (task->event_flags & EVENT_CLEAR) {
+        clear |= task->event_bits;
+      }
+
+      task->event_bits = event->bits;
+      queue_append((queue_t **)&ready, (queue_t *)task);
+    } else {
+      queue_append((queue_t **)&waiting, (queue_t *)task);
+    }
   }
 
-  if (queue->state == MQE_FINISHED) {
-    goto error;
+  event->queue = waiting;
+  event->bits &= ~clear;
+
+  int count = task_awake_all(&ready);
+  event->num_wakeups += (unsigned int)count;
+  bkl_unlock();
+  return count;
+}
+
+int event_clear(event_t *event, unsigned int bits) {
+  if (event == NULL || event->state == EVENT_FINISHED) {
+    return -1;
   }
 
-  queue->index--;
-  if (queue->index < 0) {
-    queue->index = queue->max_msgs - 1;
+  bkl_spinlock();
+  event->bits &= ~bits;
+  bkl_unlock();
+  return 0;
+}
+
+int event_wait(event_t *event, unsigned int bits, int flags,
+               unsigned int *result) {
+  if (event == NULL || event->state == EVENT_FINISHED || bits == 0) {
+    return -1;
   }
 
-  memcpy(msg, (char *)queue->msgs + ((size_t)queue->index * queue->msg_size),
-         queue->msg_size);
+  task_t *self = task_self();
 
-  if (sem_up(&(queue->sem_prod)) < 0) {
-    goto error;
+  bkl_spinlock();
+  if (__event_match(event->bits, bits, flags)) {
+    self->event_bits = event->bits;
+    if (flags & EVENT_CLEAR) {
+      event->bits &= ~bits;
+    }
+    bkl_unlock();
+  } else {
+    self->event_bits = bits;
+    self->event_flags = flags;
+
+    // The lock is kept while suspending, so no set is missed in between
+    task_suspend(&(event->queue));
+
+    if (event->state == EVENT_FINISHED) {
+      return -1;
+    }
   }
 
-  if (queue->state == MQE_FINISHED) {
-    goto error;
+  if (result) {
+    *result = self->event_bits;
   }
 
   return 0;
-error:
-  return -1;
 }
 
-int mqueue_destroy(mqueue_t *queue) {
-  if (queue == NULL || queue->state == MQE_FINISHED) {
+int event_get(event_t *event, unsigned int *bits) {
+  if (event == NULL || event->state == EVENT_FINISHED || bits == NULL) {
     return -1;
   }
 
-  queue->state = MQE_FINISHED;
-  free(queue->msgs);
+  *bits = event->bits;
+  return 0;
+}
 
-  if (sem_destroy(&(queue->sem_prod)) < 0) {
+int event_destroy(event_t *event) {
+  if (event == NULL || event->state == EVENT_FINISHED) {
     return -1;
   }
 
-  if (sem_destroy(&(queue->sem_cons)) < 0) {
-    return -1;
+  bkl_spinlock();
+  event->state = EVENT_FINISHED;
+  task_awake_all(&(event->queue));
+  bkl_unlock();
+  return 0;
+}
+
+//=============================================================================
+// Select Private Functions
+//=============================================================================
+
+/**
+ * @brief Returns the semaphore that tells if the entry is ready.
+ *
+ * @param entry Pointer for the entry of the set
+ *
+ * @return Pointer for the semaphore, or NULL if the entry is invalid.
+ */
+static semaphore_t *__select_sem(select_t *entry) {
+  if (entry->object == NULL) {
+    return NULL;
   }
 
-  return 0;
+  switch (entry->type) {
+  case SELECT_SEM:
+    return (semaphore_t *)entry->object;
+  case SELECT_MQUEUE:
+    return &(((mqueue_t *)entry->object)->sem_cons);
+  }
+
+  return NULL;
 }
 
-int mqueue_msgs(mqueue_t *queue) {
-  if (queue == NULL || queue->state == MQE_FINISHED) {
+/**
+ * @brief Fills the ready field of every entry of the set.
+ *
+ * @param set Array with the objects being watched
+ * @param num Number of entries in the array
+ *
+ * @return The number of entries ready or destroyed.
+ */
+static int __select_poll(select_t *set, int num) {
+  int count = 0;
+
+  for (int i = 0; i < num; i++) {
+    semaphore_t *sem = __select_sem(&(set[i]));
+    set[i].ready = 0;
+
+    if (sem->state == SEM_FINISHED ||
+        (set[i].type == SELECT_MQUEUE &&
+         ((mqueue_t *)set[i].object)->state == MQE_FINISHED)) {
+      set[i].ready = -1;
+    } else if (sem->lock > 0 && __sem_first(sem)) {
+      // The units reserved for the waiting tasks are not available
+      set[i].ready = 1;
+    }
+
+    if (set[i].ready) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+/**
+ * @brief Removes the entry of the watchers of its semaphore.
+ *
+ * @param entry Pointer for the entry of the set
+ */
+static void __select_unwatch(select_t *entry) {
+  select_t **aux = &(__select_sem(entry)->watchers);
+  while (*aux && *aux != entry) {
+    aux = &((*aux)->next_watch);
+  }
+
+  if (*aux) {
+    *aux = entry->next_watch;
+  }
+
+  entry->next_watch = NULL;
+  entry->waiting = NULL;
+}
+
+//=============================================================================
+// Select Functions
+//=============================================================================
+
+int ppos_select(select_t *set, int num) {
+  if (set == NULL || num <= 0) {
     return -1;
   }
 
-  return queue->num_msgs;
+  for (int i = 0; i < num; i++) {
+    if (__select_sem(&(set[i])) == NULL) {
+      return -1;
+    }
+  }
+
+  task_t *waiting = NULL;
+  while (1) {
+    bkl_spinlock();
+    int count = __select_poll(set, num);
+    if (count > 0) {
+      bkl_unlock();
+      return count;
+    }
+
+    for (int i = 0; i < num; i++) {
+      semaphore_t *sem = __select_sem(&(set[i]));
+      set[i].waiting = &waiting;
+      set[i].next_watch = sem->watchers;
+      sem->watchers = &(set[i]);
+    }
+
+    task_suspend(&waiting);
+
+    bkl_spinlock();
+    for (int i = 0; i < num; i++) {
+      __select_unwatch(&(set[i]));
+    }
+    bkl_unlock();
+  }
 }
@@ -0,0 +1,106 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppbarrier_bench.c
+ * Description: Release benchmark for the barrier. Reports how long the last
+ * task takes to put every other participant back in the ready queue.
+ * Usage: BarrierBench [participants] [rounds]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAXTASKS (10000)
+#define NUMTASKS (1000)
+#define NUMROUNDS (10)
+
+task_t *task;
+barrier_t *barrier;
+int numTasks = NUMTASKS;
+int numRounds = NUMROUNDS;
+int numReleased = 0;
+
+void taskBody(void *arg) {
+  for (int i = 0; i < numRounds; i++) {
+    barrier_join(&(barrier[i]));
+    numReleased++;
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 1 && atoi(argv[1]) <= MAXTASKS) {
+    numTasks = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) > 0) {
+    numRounds = atoi(argv[2]);
+  }
+
+  task = calloc(numTasks, sizeof(task_t));
+  barrier = calloc(numRounds, sizeof(barrier_t));
+  if (task == NULL || barrier == NULL) {
+    printf("could not allocate %d tasks\n", numTasks);
+    exit(1);
+  }
+
+  ppos_init();
+
+  // The main task is the last participant of every round
+  for (int i = 0; i < numRounds; i++) {
+    barrier_init(&(barrier[i]), numTasks + 1);
+  }
+
+  for (int i = 0; i < numTasks; i++) {
+    task_init(&(task[i]), taskBody, NULL);
+  }
+
+  unsigned long long release = 0;
+  unsigned long long worst = 0;
+  unsigned long long start = systime_ns();
+
+  for (int i = 0; i < numRounds; i++) {
+    // Waits for every other participant to arrive in the barrier
+    while (barrier[i].num_tasks > 1) {
+      task_yield();
+    }
+
+    unsigned long long begin = systime_ns();
+    barrier_join(&(barrier[i]));
+    unsigned long long elapsed = systime_ns() - begin;
+
+    release += elapsed;
+    if (elapsed > worst) {
+      worst = elapsed;
+    }
+  }
+
+  for (int i = 0; i < numTasks; i++) {
+    task_wait(&(task[i]));
+  }
+
+  unsigned long long total = systime_ns() - start;
+
+  printf("participants: %d, rounds: %d, time: %llu ms\n", numTasks + 1,
+         numRounds, total / 1000000);
+  printf("release avg: %llu us, worst: %llu us\n",
+         release / numRounds / 1000, worst / 1000);
+
+  for (int i = 0; i < numRounds; i++) {
+    barrier_destroy(&(barrier[i]));
+  }
+
+  if (numReleased != numTasks * numRounds) {
+    printf("released %d, should be %d\n", numReleased, numTasks * numRounds);
+    task_exit(1);
+  }
+
+  task_exit(0);
+}
@@ -0,0 +1,65 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppbarrier_destroy.c
+ * Description: Test of the destruction of a barrier. A task with a priority
+ * higher than the one destroying the barrier executes as soon as it is
+ * awakened, and must still see the barrier as destroyed.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define PRIO (-10)
+
+task_t waiter;
+barrier_t barrier;
+volatile int result = 1;
+int errors = 0;
+
+void waiterBody(void *arg) {
+  result = barrier_join(&barrier);
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  barrier_init(&barrier, 2);
+  task_init(&waiter, waiterBody, NULL);
+  task_setprio(&waiter, PRIO);
+
+  // Lets the waiter get to the barrier
+  task_sleep(1);
+
+  if (barrier_destroy(&barrier) < 0) {
+    errors++;
+  }
+
+  // The waiter preempted the main task when it was awakened
+  printf("%5d ms: main: espera retornou %d\n", systime(), result);
+  if (result != -1) {
+    errors++;
+  }
+
+  if (barrier_destroy(&barrier) == 0 || barrier_join(&barrier) == 0) {
+    errors++;
+  }
+
+  task_wait(&waiter);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
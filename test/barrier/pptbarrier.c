@@ -0,0 +1,86 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: pptbarrier.c
+ * Description: Test of the tree barrier. Every task counts its arrival in each
+ * phase, and checks after the release that every task arrived in that phase,
+ * with a number of tasks that does not fill the last node.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+
+#define NUMTASKS (37)
+#define NUMPHASES (200)
+
+task_t task[NUMTASKS];
+tbarrier_t b;
+
+int arrived[NUMPHASES];
+int errors = 0;
+
+void Body(void *arg) {
+  int id = (int)(long)arg;
+
+  for (int i = 0; i < NUMPHASES; i++) {
+    arrived[i]++;
+
+    // Some tasks arrive late to mix the order of the arrivals
+    if ((id + i) % 7 == 0) {
+      task_yield();
+    }
+
+    if (tbarrier_join(&b, id) < 0) {
+      errors++;
+    }
+
+    // Released before every task arrived in this phase
+    if (arrived[i] != NUMTASKS + 1) {
+      errors++;
+    }
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  // The main task is the last participant
+  tbarrier_init(&b, NUMTASKS + 1);
+
+  for (long i = 0; i < NUMTASKS; i++) {
+    task_init(&(task[i]), Body, (void *)i);
+  }
+
+  for (int i = 0; i < NUMPHASES; i++) {
+    arrived[i]++;
+    if (tbarrier_join(&b, NUMTASKS) < 0) {
+      errors++;
+    }
+
+    if (arrived[i] != NUMTASKS + 1) {
+      errors++;
+    }
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_wait(&(task[i]));
+  }
+
+  tbarrier_destroy(&b);
+
+  printf("%5d ms: main: %d fases, %d erros\n", systime(), NUMPHASES, errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
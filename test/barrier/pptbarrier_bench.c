@@ -0,0 +1,104 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: pptbarrier_bench.c
+ * Description: Phase throughput benchmark of the barriers. Every task joins
+ * the same barrier in each phase, first with the central barrier and then with
+ * the tree barrier.
+ * Usage: TreeBarrierBench [participants] [phases]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAXTASKS (10000)
+#define NUMTASKS (100)
+#define NUMPHASES (1000)
+
+task_t *task;
+barrier_t b;
+tbarrier_t tb;
+int numTasks = NUMTASKS;
+int numPhases = NUMPHASES;
+long int phases = 0;
+
+void barrierBody(void *arg) {
+  for (int i = 0; i < numPhases; i++) {
+    barrier_join(&b);
+  }
+
+  task_exit(0);
+}
+
+void treeBody(void *arg) {
+  int id = (int)(long)arg;
+
+  for (int i = 0; i < numPhases; i++) {
+    tbarrier_join(&tb, id);
+    if (id == 0) {
+      phases++;
+    }
+  }
+
+  task_exit(0);
+}
+
+// Runs every phase with the given body and returns the elapsed time in ns
+unsigned long long run(void (*body)(void *)) {
+  unsigned long long start = systime_ns();
+
+  for (long i = 0; i < numTasks; i++) {
+    task_init(&(task[i]), body, (void *)i);
+  }
+
+  for (int i = 0; i < numTasks; i++) {
+    task_wait(&(task[i]));
+  }
+
+  return systime_ns() - start;
+}
+
+void report(char *name, unsigned long long elapsed) {
+  printf("%s: %d phases in %llu ms, %.0f phases/s\n", name, numPhases,
+         elapsed / 1000000, (double)numPhases * 1e9 / (double)elapsed);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 1 && atoi(argv[1]) <= MAXTASKS) {
+    numTasks = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) > 0) {
+    numPhases = atoi(argv[2]);
+  }
+
+  task = calloc(numTasks, sizeof(task_t));
+  if (task == NULL) {
+    printf("could not allocate %d tasks\n", numTasks);
+    exit(1);
+  }
+
+  ppos_init();
+  printf("participants: %d, phases: %d\n", numTasks, numPhases);
+
+  barrier_init(&b, numTasks);
+  report("barrier", run(barrierBody));
+  barrier_destroy(&b);
+
+  tbarrier_init(&tb, numTasks);
+  report("tree barrier", run(treeBody));
+  tbarrier_destroy(&tb);
+
+  if (phases != numPhases) {
+    printf("phases %ld, should be %d\n", phases, numPhases);
+    task_exit(1);
+  }
+
+  task_exit(0);
+}
@@ -0,0 +1,112 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppbcast.c
+ * Description: Test of the broadcast ring. With BCAST_BLOCK every subscriber
+ * receives every message in order, even the slow ones. With BCAST_DROP the
+ * sender never waits, and the subscribers receive the newest messages in
+ * order, counting the ones they lost.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+
+#define NUMSUBS (4)
+#define NUMMSGS (500)
+#define MAXMSGS (8)
+
+task_t pub, subs[NUMSUBS];
+bcast_t ring;
+bcast_sub_t cursors[NUMSUBS];
+int last[NUMSUBS], received[NUMSUBS];
+int errors = 0;
+
+void pubBody(void *arg) {
+  for (int i = 0; i < NUMMSGS; i++) {
+    if (bcast_send(&ring, &i) < 0) {
+      errors++;
+    }
+  }
+
+  task_exit(0);
+}
+
+void subBody(void *arg) {
+  int id = (int)(long)arg;
+  int value;
+
+  last[id] = -1;
+  received[id] = 0;
+  while (last[id] < NUMMSGS - 1 && bcast_recv(&(cursors[id]), &value) == 0) {
+    // The messages are always received in order
+    if (value <= last[id]) {
+      errors++;
+    }
+
+    // Without drops no message is skipped
+    if (ring.policy == BCAST_BLOCK && value != last[id] + 1) {
+      errors++;
+    }
+    last[id] = value;
+    received[id]++;
+
+    // The subscribers with a higher id are slower
+    for (int j = 0; j < id; j++) {
+      task_yield();
+    }
+  }
+
+  task_exit(0);
+}
+
+void run(bcast_policy policy, char *name) {
+  bcast_init(&ring, MAXMSGS, sizeof(int), policy);
+
+  for (long i = 0; i < NUMSUBS; i++) {
+    bcast_subscribe(&ring, &(cursors[i]));
+    task_init(&(subs[i]), subBody, (void *)i);
+  }
+  task_init(&pub, pubBody, NULL);
+
+  task_wait(&pub);
+  for (int i = 0; i < NUMSUBS; i++) {
+    task_wait(&(subs[i]));
+
+    // Every message was received or counted as dropped
+    if (policy == BCAST_BLOCK && cursors[i].num_drops) {
+      errors++;
+    }
+
+    if (cursors[i].seq != NUMMSGS || last[i] != NUMMSGS - 1 ||
+        received[i] + (int)cursors[i].num_drops != NUMMSGS) {
+      errors++;
+    }
+
+    printf("%5d ms: main: %s, assinante %d perdeu %lu\n", systime(), name, i,
+           cursors[i].num_drops);
+    bcast_unsubscribe(&(cursors[i]));
+  }
+
+  bcast_destroy(&ring);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  run(BCAST_BLOCK, "BCAST_BLOCK");
+  run(BCAST_DROP, "BCAST_DROP");
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
@@ -0,0 +1,129 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppbcast_bench.c
+ * Description: Fan-out benchmark. Sends the same messages to every consumer,
+ * first with a message queue per consumer, and then with a single broadcast
+ * ring read by every consumer.
+ * Usage: BroadcastBench [messages] [consumers] [msg size]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUMMSGS (100000)
+#define NUMCONS (8)
+#define MAXCONS (64)
+#define MSGSIZE (256)
+#define MAXMSGS (32)
+
+task_t prod, cons[MAXCONS];
+mqueue_t queues[MAXCONS];
+bcast_t ring;
+bcast_sub_t cursors[MAXCONS];
+int numMsgs = NUMMSGS;
+int numCons = NUMCONS;
+int msgSize = MSGSIZE;
+
+void queueProd(void *arg) {
+  char *msg = calloc(1, (size_t)msgSize);
+  for (int i = 0; i < numMsgs; i++) {
+    for (int j = 0; j < numCons; j++) {
+      mqueue_send(&(queues[j]), msg);
+    }
+  }
+
+  free(msg);
+  task_exit(0);
+}
+
+void queueCons(void *arg) {
+  int id = (int)(long)arg;
+  char *msg = malloc((size_t)msgSize);
+  for (int i = 0; i < numMsgs; i++) {
+    mqueue_recv(&(queues[id]), msg);
+  }
+
+  free(msg);
+  task_exit(0);
+}
+
+void ringProd(void *arg) {
+  char *msg = calloc(1, (size_t)msgSize);
+  for (int i = 0; i < numMsgs; i++) {
+    bcast_send(&ring, msg);
+  }
+
+  free(msg);
+  task_exit(0);
+}
+
+void ringCons(void *arg) {
+  int id = (int)(long)arg;
+  char *msg = malloc((size_t)msgSize);
+  for (int i = 0; i < numMsgs; i++) {
+    bcast_recv(&(cursors[id]), msg);
+  }
+
+  free(msg);
+  task_exit(0);
+}
+
+void run(char *name, void (*prodBody)(void *), void (*consBody)(void *)) {
+  unsigned long long start = systime_ns();
+
+  for (long i = 0; i < numCons; i++) {
+    task_init(&(cons[i]), consBody, (void *)i);
+  }
+  task_init(&prod, prodBody, NULL);
+
+  task_wait(&prod);
+  for (int i = 0; i < numCons; i++) {
+    task_wait(&(cons[i]));
+  }
+
+  unsigned long long elapsed = systime_ns() - start;
+  printf("%s: %llu ms, %.0f msgs/s\n", name, elapsed / 1000000,
+         (double)numMsgs * 1e9 / (double)elapsed);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 0) {
+    numMsgs = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) > 0 && atoi(argv[2]) <= MAXCONS) {
+    numCons = atoi(argv[2]);
+  }
+
+  if (argc > 3 && atoi(argv[3]) > 0) {
+    msgSize = atoi(argv[3]);
+  }
+
+  ppos_init();
+  printf("messages: %d, consumers: %d, msg size: %d\n", numMsgs, numCons,
+         msgSize);
+
+  for (int i = 0; i < numCons; i++) {
+    mqueue_init(&(queues[i]), MAXMSGS, msgSize);
+  }
+  run("mqueue per consumer", queueProd, queueCons);
+  for (int i = 0; i < numCons; i++) {
+    mqueue_destroy(&(queues[i]));
+  }
+
+  bcast_init(&ring, MAXMSGS, msgSize, BCAST_BLOCK);
+  for (int i = 0; i < numCons; i++) {
+    bcast_subscribe(&ring, &(cursors[i]));
+  }
+  run("broadcast ring", ringProd, ringCons);
+  bcast_destroy(&ring);
+
+  task_exit(0);
+}
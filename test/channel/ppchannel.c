@@ -0,0 +1,110 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppchannel.c
+ * Description: Test of the variable-length channels. A producer sends records
+ * of many sizes through a small buffer, so they wrap around its end, and the
+ * consumer checks the length and the contents of each one, in both modes.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUMMSGS (2000)
+#define CHANSIZE (256)
+#define MAXLEN (200)
+
+task_t prod, cons;
+channel_t chan;
+int errors = 0;
+
+// Length of the i-th message
+int msgLen(int i) { return (i * 37) % MAXLEN; }
+
+void prodBody(void *arg) {
+  char msg[MAXLEN];
+
+  for (int i = 0; i < NUMMSGS; i++) {
+    memset(msg, i & 0xff, (size_t)msgLen(i));
+    if (channel_send(&chan, msg, msgLen(i)) < 0) {
+      errors++;
+    }
+
+    if (i % 13 == 0) {
+      task_yield();
+    }
+  }
+
+  task_exit(0);
+}
+
+void consBody(void *arg) {
+  char msg[MAXLEN];
+
+  for (int i = 0; i < NUMMSGS; i++) {
+    int len = channel_recv(&chan, msg, MAXLEN);
+    if (len != msgLen(i)) {
+      printf("mensagem %d com %d bytes, deveria ter %d\n", i, len, msgLen(i));
+      errors++;
+      continue;
+    }
+
+    for (int j = 0; j < len; j++) {
+      if (msg[j] != (char)(i & 0xff)) {
+        errors++;
+        break;
+      }
+    }
+
+    if (i % 7 == 0) {
+      task_yield();
+    }
+  }
+
+  task_exit(0);
+}
+
+void run(channel_mode mode, char *name) {
+  channel_init(&chan, CHANSIZE, mode);
+
+  task_init(&prod, prodBody, NULL);
+  task_init(&cons, consBody, NULL);
+  task_wait(&prod);
+  task_wait(&cons);
+
+  // Records that can never fit, and buffers too small, are refused
+  char msg[CHANSIZE];
+  if (channel_send(&chan, msg, CHANSIZE) == 0) {
+    errors++;
+  }
+
+  channel_send(&chan, msg, 10);
+  if (channel_msgs(&chan) != 1 || channel_recv(&chan, msg, 5) >= 0 ||
+      channel_recv(&chan, msg, 10) != 10 || channel_msgs(&chan) != 0) {
+    errors++;
+  }
+
+  channel_destroy(&chan);
+  printf("%5d ms: main: %s, %d erros\n", systime(), name, errors);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  run(CHAN_SPLIT, "CHAN_SPLIT");
+  run(CHAN_NOSPLIT, "CHAN_NOSPLIT");
+
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
@@ -0,0 +1,121 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppchannel_bench.c
+ * Description: Throughput benchmark of messages with variable sizes. Sends the
+ * same messages through a message queue, padded to the max size, and through
+ * the channels in both modes.
+ * Usage: ChannelBench [messages] [max size]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUMMSGS (200000)
+#define MAXSIZE (1024)
+#define QUEUEMSGS (64)
+
+task_t prod, cons;
+mqueue_t queue;
+channel_t chan;
+int numMsgs = NUMMSGS;
+int maxSize = MAXSIZE;
+int *lengths;
+long long payload = 0;
+
+void queueProd(void *arg) {
+  char *msg = calloc(1, (size_t)maxSize);
+  for (int i = 0; i < numMsgs; i++) {
+    mqueue_send(&queue, msg);
+  }
+
+  free(msg);
+  task_exit(0);
+}
+
+void queueCons(void *arg) {
+  char *msg = malloc((size_t)maxSize);
+  for (int i = 0; i < numMsgs; i++) {
+    mqueue_recv(&queue, msg);
+  }
+
+  free(msg);
+  task_exit(0);
+}
+
+void chanProd(void *arg) {
+  char *msg = calloc(1, (size_t)maxSize);
+  for (int i = 0; i < numMsgs; i++) {
+    channel_send(&chan, msg, lengths[i]);
+  }
+
+  free(msg);
+  task_exit(0);
+}
+
+void chanCons(void *arg) {
+  char *msg = malloc((size_t)maxSize);
+  for (int i = 0; i < numMsgs; i++) {
+    channel_recv(&chan, msg, maxSize);
+  }
+
+  free(msg);
+  task_exit(0);
+}
+
+void run(char *name, void (*prodBody)(void *), void (*consBody)(void *),
+         long long copied) {
+  unsigned long long start = systime_ns();
+
+  task_init(&prod, prodBody, NULL);
+  task_init(&cons, consBody, NULL);
+  task_wait(&prod);
+  task_wait(&cons);
+
+  unsigned long long elapsed = systime_ns() - start;
+  printf("%s: %llu ms, %.0f msgs/s, %lld bytes copied per side\n", name,
+         elapsed / 1000000, (double)numMsgs * 1e9 / (double)elapsed, copied);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 0) {
+    numMsgs = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) > 0) {
+    maxSize = atoi(argv[2]);
+  }
+
+  // Most of the messages are small, with a few of them close to the max size
+  lengths = malloc(sizeof(int) * (size_t)numMsgs);
+  for (int i = 0; i < numMsgs; i++) {
+    lengths[i] = (rand() % 8 == 0) ? rand() % maxSize + 1 : rand() % 64 + 1;
+    payload += lengths[i];
+  }
+
+  ppos_init();
+  printf("messages: %d, max size: %d, avg size: %lld\n", numMsgs, maxSize,
+         payload / numMsgs);
+
+  mqueue_init(&queue, QUEUEMSGS, maxSize);
+  run("mqueue", queueProd, queueCons, (long long)numMsgs * maxSize);
+  mqueue_destroy(&queue);
+
+  // Same memory as the message queue
+  channel_init(&chan, QUEUEMSGS * maxSize, CHAN_SPLIT);
+  run("channel split", chanProd, chanCons, payload);
+  channel_destroy(&chan);
+
+  channel_init(&chan, QUEUEMSGS * maxSize, CHAN_NOSPLIT);
+  run("channel nosplit", chanProd, chanCons, payload);
+  channel_destroy(&chan);
+
+  free(lengths);
+  task_exit(0);
+}
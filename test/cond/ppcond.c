@@ -0,0 +1,127 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppcond.c
+ * Description: Test of the condition variables. The tasks wait for a start
+ * signal sent through a broadcast, and then exchange values through a bounded
+ * buffer protected by a mutex and two condition variables.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+
+#define NUMPROD (4)
+#define NUMCONS (4)
+#define NUMITEMS (5000) // Items sent by each producer
+#define BUFSIZE (8)
+
+task_t prod[NUMPROD], cons[NUMCONS];
+mutex_t m;
+cond_t notFull, notEmpty, start;
+
+int buffer[BUFSIZE];
+int head = 0, tail = 0, count = 0;
+int started = 0;
+long int sent = 0, received = 0;
+
+void waitStart() {
+  mutex_lock(&m);
+  while (!started) {
+    cond_wait(&start, &m);
+  }
+  mutex_unlock(&m);
+}
+
+void prodBody(void *arg) {
+  waitStart();
+
+  for (int i = 1; i <= NUMITEMS; i++) {
+    mutex_lock(&m);
+    while (count == BUFSIZE) {
+      cond_wait(&notFull, &m);
+    }
+
+    buffer[tail] = i;
+    tail = (tail + 1) % BUFSIZE;
+    count++;
+    sent += i;
+
+    cond_signal(&notEmpty);
+    mutex_unlock(&m);
+  }
+
+  task_exit(0);
+}
+
+void consBody(void *arg) {
+  waitStart();
+
+  for (int i = 0; i < NUMITEMS * NUMPROD / NUMCONS; i++) {
+    mutex_lock(&m);
+    while (count == 0) {
+      cond_wait(&notEmpty, &m);
+    }
+
+    received += buffer[head];
+    head = (head + 1) % BUFSIZE;
+    count--;
+
+    cond_signal(&notFull);
+    mutex_unlock(&m);
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  printf("main: inicio\n");
+  ppos_init();
+
+  mutex_init(&m);
+  cond_init(&notFull);
+  cond_init(&notEmpty);
+  cond_init(&start);
+
+  for (int i = 0; i < NUMPROD; i++) {
+    task_init(&(prod[i]), prodBody, NULL);
+  }
+
+  for (int i = 0; i < NUMCONS; i++) {
+    task_init(&(cons[i]), consBody, NULL);
+  }
+
+  // Lets every task wait for the start signal
+  task_sleep(50);
+
+  mutex_lock(&m);
+  started = 1;
+  cond_broadcast(&start);
+  mutex_unlock(&m);
+
+  for (int i = 0; i < NUMPROD; i++) {
+    task_wait(&(prod[i]));
+  }
+
+  for (int i = 0; i < NUMCONS; i++) {
+    task_wait(&(cons[i]));
+  }
+
+  cond_destroy(&start);
+  cond_destroy(&notEmpty);
+  cond_destroy(&notFull);
+  mutex_destroy(&m);
+
+  if (sent == received && count == 0) {
+    printf("Enviado %ld, recebido %ld, correto!\n", sent, received);
+  } else {
+    printf("Enviado %ld, recebido %ld, errado!\n", sent, received);
+    task_exit(1);
+  }
+
+  printf("main: fim\n");
+  task_exit(0);
+}
@@ -0,0 +1,123 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppcond_destroy.c
+ * Description: Test of the destruction of a condition variable. The tasks
+ * waiting for it must return with an error, without holding the mutex, so the
+ * mutex can still be locked by the other tasks. A task signaled before the
+ * destruction, but that did not get the mutex yet, must return as signaled.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMTASKS (2)
+
+task_t tasks[NUMTASKS], late;
+mutex_t m;
+cond_t c, signaled;
+int result[NUMTASKS], lateResult = 1;
+int errors = 0;
+
+void waiterBody(void *arg) {
+  long i = (long)arg;
+
+  mutex_lock(&m);
+  result[i] = cond_wait(&c, &m);
+
+  // Unlocks the mutex kept by the wait, so the other tasks can go on
+  if (m.owner == &(tasks[i])) {
+    errors++;
+    mutex_unlock(&m);
+  }
+
+  task_exit(0);
+}
+
+void lateBody(void *arg) {
+  mutex_lock(&m);
+  lateResult = cond_wait(&signaled, &m);
+
+  // Keeps the mutex, as the wait was signaled
+  if (lateResult == 0) {
+    if (m.owner != &late) {
+      errors++;
+    }
+    mutex_unlock(&m);
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  mutex_init(&m);
+  cond_init(&c);
+
+  // The first task executes as soon as it gets the mutex
+  for (long i = 0; i < NUMTASKS; i++) {
+    result[i] = 1;
+    task_init(&(tasks[i]), waiterBody, (void *)i);
+  }
+  task_setprio(&(tasks[0]), -10);
+  task_setprio(&(tasks[1]), 10);
+
+  // Lets every task wait for the condition
+  task_sleep(10);
+
+  if (cond_destroy(&c) < 0) {
+    errors++;
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_wait(&(tasks[i]));
+    printf("%5d ms: main: tarefa %d: espera retornou %d\n", systime(), i,
+           result[i]);
+    if (result[i] != -1) {
+      errors++;
+    }
+  }
+
+  if (m.owner != NULL || mutex_lock(&m) < 0 || mutex_unlock(&m) < 0) {
+    errors++;
+  }
+
+  if (cond_destroy(&c) == 0 || cond_signal(&c) == 0) {
+    errors++;
+  }
+
+  // The task is signaled and the condition destroyed while the mutex is held
+  cond_init(&signaled);
+  task_init(&late, lateBody, NULL);
+  task_sleep(10);
+
+  mutex_lock(&m);
+  cond_signal(&signaled);
+  cond_destroy(&signaled);
+  mutex_unlock(&m);
+
+  task_wait(&late);
+  printf("%5d ms: main: tarefa sinalizada: espera retornou %d\n", systime(),
+         lateResult);
+  if (lateResult != 0) {
+    errors++;
+  }
+
+  mutex_destroy(&m);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
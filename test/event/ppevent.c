@@ -0,0 +1,164 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppevent.c
+ * Description: Test of the event groups. A consumer waits for data and credit
+ * at the same time, several waiters are released by a single set, and the bits
+ * waited with EVENT_CLEAR are cleared only after every waiter saw them.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMTASKS (6)
+#define NUMITEMS (20)
+
+#define DATA_READY (1 << 0)
+#define CREDIT (1 << 1)
+#define START (1 << 2)
+#define STOP (1 << 3)
+#define UNUSED (1 << 4)
+
+task_t task[NUMTASKS], producer, consumer;
+event_t flow, group;
+int produced = 0, consumed = 0;
+int started = 0;
+unsigned int seen[NUMTASKS];
+int errors = 0;
+
+/**
+ * Sleeps until the bit is cleared by the consumer.
+ */
+void waitCleared(unsigned int bit, int time) {
+  unsigned int bits;
+  do {
+    task_sleep(time);
+    event_get(&flow, &bits);
+  } while (bits & bit);
+}
+
+void producerBody(void *arg) {
+  for (int i = 0; i < NUMITEMS; i++) {
+    produced++;
+    event_set(&flow, DATA_READY);
+    waitCleared(DATA_READY, 2);
+  }
+
+  task_exit(0);
+}
+
+void consumerBody(void *arg) {
+  for (int i = 0; i < NUMITEMS; i++) {
+    // Only consumes with data and a credit, each one used once
+    unsigned int bits;
+    if (event_wait(&flow, DATA_READY | CREDIT, EVENT_ALL | EVENT_CLEAR, &bits)
+        < 0) {
+      errors++;
+    }
+
+    if ((bits & (DATA_READY | CREDIT)) != (DATA_READY | CREDIT)) {
+      errors++;
+    }
+
+    consumed++;
+  }
+
+  task_exit(0);
+}
+
+void waiterBody(void *arg) {
+  int id = (int)(long)arg;
+
+  // Half of the tasks wait for START alone, and the other half for START or
+  // STOP clearing them
+  int flags = id % 2 ? EVENT_CLEAR : 0;
+  unsigned int bits = id % 2 ? START | STOP : START;
+  if (event_wait(&group, bits, flags, &(seen[id])) < 0) {
+    errors++;
+  }
+
+  started++;
+
+  // Waits again until the group is destroyed
+  if (event_wait(&group, STOP, EVENT_ALL, NULL) == 0) {
+    errors++;
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  // The consumer needs data and credit together
+  event_init(&flow, 0);
+  task_init(&producer, producerBody, NULL);
+  task_init(&consumer, consumerBody, NULL);
+
+  for (int i = 0; i < NUMITEMS; i++) {
+    event_set(&flow, CREDIT);
+    waitCleared(CREDIT, 3);
+  }
+
+  task_wait(&producer);
+  task_wait(&consumer);
+  printf("%5d ms: main: %d produzidos, %d consumidos\n", systime(), produced,
+         consumed);
+  if (consumed != NUMITEMS) {
+    errors++;
+  }
+  event_destroy(&flow);
+
+  // A single set releases every waiter
+  event_init(&group, 0);
+  for (long i = 0; i < NUMTASKS; i++) {
+    task_init(&(task[i]), waiterBody, (void *)i);
+  }
+
+  task_sleep(10);
+  if (event_set(&group, UNUSED) != 0 || started) {
+    errors++;
+  }
+  event_clear(&group, UNUSED);
+
+  int awakened = event_set(&group, START);
+  task_sleep(10);
+
+  unsigned int bits;
+  event_get(&group, &bits);
+  printf("%5d ms: main: %d acordadas, %d iniciadas, bits %#x\n", systime(),
+         awakened, started, bits);
+  if (awakened != NUMTASKS || started != NUMTASKS || bits != 0) {
+    errors++;
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    if (!(seen[i] & START)) {
+      errors++;
+    }
+  }
+
+  event_destroy(&group);
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_wait(&(task[i]));
+  }
+
+  if (event_wait(&group, START, 0, NULL) == 0) {
+    errors++;
+  }
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
@@ -90,6 +90,14 @@ queueint_t *create_itens() {
   return items;
 }
 
+// Orders the elements by the rest of the index divided by 7
+int compare_elem(const void *ptr1, const void *ptr2) {
+  const queueint_t *elem1 = ptr1;
+  const queueint_t *elem2 = ptr2;
+
+  return (elem1->index % 7) - (elem2->index % 7);
+}
+
 //------------------------------------------------------------------------------
 // Test Functions
 //------------------------------------------------------------------------------
@@ -466,6 +474,63 @@ int queue_insert_double_queue() {
   return 0;
 }
 
+int queue_merge_inorder_test() {
+  queueint_t *items = create_itens();
+
+  queueint_t *queue0 = NULL;
+  queueint_t *queue1 = NULL;
+  for (int i = 0; i < N / 2; i++) {
+    queue_insert_inorder((queue_t **)&queue0, (queue_t *)&(items[i]),
+                         compare_elem);
+  }
+
+  for (int i = N / 2; i < N; i++) {
+    queue_append((queue_t **)&queue1, (queue_t *)&(items[i]));
+  }
+
+  int moved = queue_merge_inorder((queue_t **)&queue0, (queue_t **)&queue1,
+                                  compare_elem);
+  if (moved != N / 2) {
+    printf("Wrong number of elements moved [%d] should be [%d]\n", moved,
+           N / 2);
+    free(items);
+    return 1;
+  }
+
+  if (queue1 != NULL || check_queue(queue0) ||
+      queue_size((queue_t *)queue0) != N) {
+    printf("Queue is not correct\n");
+    free(items);
+    return 1;
+  }
+
+  // The equal elements should keep the order in which they were inserted
+  queueint_t *aux = queue0;
+  do {
+    if (aux->next != queue0 &&
+        (compare_elem(aux, aux->next) > 0 ||
+         (compare_elem(aux, aux->next) == 0 && aux->index > aux->next->index))) {
+      printf("Wrong order between [%d] and [%d]\n", aux->index,
+             aux->next->index);
+      free(items);
+      return 1;
+    }
+
+    aux = aux->next;
+  } while (aux != queue0);
+
+  // Merging an empty queue should not change anything
+  if (queue_merge_inorder((queue_t **)&queue0, (queue_t **)&queue1,
+                          compare_elem) != 0) {
+    printf("Merge of an empty queue should not move elements\n");
+    free(items);
+    return 1;
+  }
+
+  free(items);
+  return 0;
+}
+
 //------------------------------------------------------------------------------
 // Main Functions
 //------------------------------------------------------------------------------
@@ -521,5 +586,10 @@ int main() {
     return 1;
   }
 
+  if (queue_merge_inorder_test()) {
+    printf("TEST FAILED: queue_merge_inorder_test\n");
+    return 1;
+  }
+
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppmqueue_prio.c
+ * Description: Test of the message queues ordered by priority. Checks that
+ * the messages are received by priority, and in the order they were sent
+ * inside the same priority, also with tasks blocked on a full queue.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+
+#define NUMPRIOS (4)
+#define NUMMSGS (300)
+#define MAXMSGS (8)
+
+typedef struct msg_t {
+  int prio;
+  int seq;
+} msg_t;
+
+task_t prod[NUMPRIOS], cons;
+mqueue_t fifo, queue;
+int received[NUMPRIOS];
+int errors = 0;
+
+void prodBody(void *arg) {
+  int prio = (int)(long)arg;
+
+  for (int i = 0; i < NUMMSGS; i++) {
+    msg_t msg = {.prio = prio, .seq = i};
+    if (mqueue_send_prio(&queue, &msg, prio) < 0) {
+      errors++;
+    }
+  }
+
+  task_exit(0);
+}
+
+void consBody(void *arg) {
+  for (int i = 0; i < NUMPRIOS * NUMMSGS; i++) {
+    msg_t msg;
+    mqueue_recv(&queue, &msg);
+
+    // Each priority keeps the order of its producer
+    if (msg.seq != received[msg.prio]) {
+      errors++;
+    }
+    received[msg.prio]++;
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  // A queue with a single priority delivers in the order of arrival
+  mqueue_init(&fifo, MAXMSGS, sizeof(int));
+  for (int i = 0; i < MAXMSGS; i++) {
+    mqueue_send(&fifo, &i);
+  }
+
+  for (int i = 0; i < MAXMSGS; i++) {
+    int value;
+    mqueue_recv(&fifo, &value);
+    if (value != i) {
+      printf("%5d ms: main: recebeu %d, deveria ser %d\n", systime(), value, i);
+      errors++;
+    }
+  }
+  mqueue_destroy(&fifo);
+
+  // Without concurrency the order is by priority and then by arrival
+  mqueue_init_prio(&queue, MAXMSGS, sizeof(msg_t), NUMPRIOS);
+  int prios[MAXMSGS] = {3, 1, 2, 1, 0, 3, 0, 2};
+  for (int i = 0; i < MAXMSGS; i++) {
+    msg_t msg = {.prio = prios[i], .seq = i};
+    mqueue_send_prio(&queue, &msg, prios[i]);
+  }
+
+  msg_t last = {.prio = 0, .seq = -1};
+  for (int i = 0; i < MAXMSGS; i++) {
+    msg_t msg;
+    mqueue_recv(&queue, &msg);
+    if (msg.prio < last.prio || (msg.prio == last.prio && msg.seq < last.seq)) {
+      printf("%5d ms: main: ordem errada em %d\n", systime(), i);
+      errors++;
+    }
+    last = msg;
+  }
+
+  if (mqueue_send_prio(&queue, &last, NUMPRIOS) == 0) {
+    errors++;
+  }
+
+  // With the producers blocked on the full queue
+  task_init(&cons, consBody, NULL);
+  for (long i = 0; i < NUMPRIOS; i++) {
+    task_init(&(prod[i]), prodBody, (void *)i);
+  }
+
+  task_wait(&cons);
+  for (int i = 0; i < NUMPRIOS; i++) {
+    task_wait(&(prod[i]));
+    if (received[i] != NUMMSGS) {
+      errors++;
+    }
+  }
+  mqueue_destroy(&queue);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
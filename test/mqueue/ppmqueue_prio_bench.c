@@ -0,0 +1,130 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppmqueue_prio_bench.c
+ * Description: Latency benchmark of control messages under a saturated
+ * message queue. A producer keeps the queue full of data messages, while the
+ * control task sends a message periodically. Runs with a queue in the order of
+ * arrival, and with a queue ordered by priority.
+ * Usage: MessageQueuePrioBench [duration ms] [max msgs]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DURATION (2000)
+#define MAXMSGS (64)
+#define PERIOD (5)
+#define WORK (20000)
+
+typedef struct msg_t {
+  int control;
+  unsigned long long sent;
+} msg_t;
+
+task_t prod, control, cons;
+mqueue_t queues[2];
+mqueue_t *queue;
+int duration = DURATION;
+int maxMsgs = MAXMSGS;
+int running;
+
+unsigned long long latency, worst;
+int numControl, numData;
+
+void prodBody(void *arg) {
+  msg_t msg = {.control = 0};
+  while (running) {
+    msg.sent = systime_ns();
+    mqueue_send(queue, &msg);
+  }
+
+  task_exit(0);
+}
+
+void controlBody(void *arg) {
+  msg_t msg = {.control = 1};
+  while (running) {
+    task_sleep(PERIOD);
+    msg.sent = systime_ns();
+    mqueue_send_prio(queue, &msg, 0);
+  }
+
+  task_exit(0);
+}
+
+void consBody(void *arg) {
+  msg_t msg;
+  while (mqueue_recv(queue, &msg) == 0) {
+    if (msg.control) {
+      unsigned long long elapsed = systime_ns() - msg.sent;
+      latency += elapsed;
+      if (elapsed > worst) {
+        worst = elapsed;
+      }
+      numControl++;
+    } else {
+      numData++;
+    }
+
+    // Handling a data message takes some time
+    for (volatile int i = 0; i < WORK; i++)
+      ;
+  }
+
+  task_exit(0);
+}
+
+void run(char *name, int num_prios) {
+  queue = &(queues[num_prios - 1]);
+  latency = worst = 0;
+  numControl = numData = 0;
+  running = 1;
+
+  mqueue_init_prio(queue, maxMsgs, sizeof(msg_t), num_prios);
+  task_init(&cons, consBody, NULL);
+  task_init(&prod, prodBody, NULL);
+  task_init(&control, controlBody, NULL);
+
+  task_sleep(duration);
+  running = 0;
+  task_wait(&control);
+  task_wait(&prod);
+
+  // The consumer empties the queue before it is destroyed
+  while (mqueue_msgs(queue) > 0) {
+    task_yield();
+  }
+  mqueue_destroy(queue);
+  task_wait(&cons);
+
+  printf("%s: data %d, control %d, control latency avg %.2f ms, max %.2f ms\n",
+         name, numData, numControl,
+         numControl ? (double)latency / numControl / 1e6 : 0.0,
+         (double)worst / 1e6);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 0) {
+    duration = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) > 0) {
+    maxMsgs = atoi(argv[2]);
+  }
+
+  ppos_init();
+  printf("duration: %d ms, max msgs: %d\n", duration, maxMsgs);
+
+  // With a single priority every message is sent with the same priority
+  run("arrival order", 1);
+  run("priority order", 2);
+
+  task_exit(0);
+}
@@ -0,0 +1,64 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppmutex.c
+ * Description: Race condition test of the mutex, with tasks of different
+ * priorities competing for the same mutex.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+
+#define NUMTASKS (10)
+#define NUMSTEPS (20000)
+
+task_t task[NUMTASKS];
+mutex_t m;
+long int soma = 0;
+
+void taskBody(void *arg) {
+  for (int i = 0; i < NUMSTEPS; i++) {
+    mutex_lock(&m);
+    long int aux = soma;
+    for (volatile int j = 0; j < 500; j++) {
+    }
+    soma = aux + 1;
+    mutex_unlock(&m);
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  printf("main: inicio\n");
+  ppos_init();
+
+  mutex_init(&m);
+
+  printf("%d tarefas somando %d vezes cada, aguarde\n", NUMTASKS, NUMSTEPS);
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_init(&(task[i]), taskBody, NULL);
+    task_setprio(&(task[i]), (i % 3 - 1) * 5);
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_wait(&(task[i]));
+  }
+
+  mutex_destroy(&m);
+
+  if (soma == ((long)NUMSTEPS * NUMTASKS)) {
+    printf("Soma deu %ld valor correto!\n", soma);
+  } else {
+    printf("Soma deu %ld, deveria ser %ld\n", soma, (long)NUMSTEPS * NUMTASKS);
+    task_exit(1);
+  }
+
+  printf("main: fim\n");
+  task_exit(0);
+}
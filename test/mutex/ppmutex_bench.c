@@ -0,0 +1,121 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppmutex_bench.c
+ * Description: Contention benchmark for the mutex. Low priority tasks compete
+ * for the mutex, while medium priority tasks only use the CPU and a high
+ * priority task measures how long it takes to get the mutex.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUMLOCKERS (4)
+#define NUMHOGS (4)
+#define DURATION (3000) // In milliseconds
+#define PERIOD (10)     // In milliseconds
+
+task_t lockers[NUMLOCKERS], hogs[NUMHOGS], urgent;
+mutex_t m;
+unsigned int endTime = 0;
+unsigned long acquisitions = 0;
+unsigned int maxLatency = 0;
+unsigned long totalLatency = 0;
+unsigned int numLatency = 0;
+
+// Holds the mutex for a long critical section
+void lockerBody(void *arg) {
+  while (systime() < endTime) {
+    mutex_lock(&m);
+    for (volatile int i = 0; i < 200000; i++) {
+    }
+    acquisitions++;
+    mutex_unlock(&m);
+  }
+
+  task_exit(0);
+}
+
+// Only uses the CPU, without touching the mutex
+void hogBody(void *arg) {
+  while (systime() < endTime) {
+    for (volatile int i = 0; i < 10000; i++) {
+    }
+  }
+
+  task_exit(0);
+}
+
+// Periodically measures the latency of getting the mutex
+void urgentBody(void *arg) {
+  while (systime() < endTime) {
+    task_sleep(PERIOD);
+
+    unsigned int start = systime();
+    mutex_lock(&m);
+    unsigned int latency = systime() - start;
+    acquisitions++;
+    mutex_unlock(&m);
+
+    totalLatency += latency;
+    numLatency++;
+    if (latency > maxLatency) {
+      maxLatency = latency;
+    }
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  unsigned int duration = DURATION;
+  if (argc > 1) {
+    duration = (unsigned int)atoi(argv[1]);
+  }
+
+  ppos_init();
+  mutex_init(&m);
+
+  endTime = systime() + duration;
+
+  for (int i = 0; i < NUMLOCKERS; i++) {
+    task_init(&(lockers[i]), lockerBody, NULL);
+    task_setprio(&(lockers[i]), 10);
+  }
+
+  for (int i = 0; i < NUMHOGS; i++) {
+    task_init(&(hogs[i]), hogBody, NULL);
+    task_setprio(&(hogs[i]), 0);
+  }
+
+  task_init(&urgent, urgentBody, NULL);
+  task_setprio(&urgent, -10);
+
+  task_wait(&urgent);
+  for (int i = 0; i < NUMLOCKERS; i++) {
+    task_wait(&(lockers[i]));
+  }
+  for (int i = 0; i < NUMHOGS; i++) {
+    task_wait(&(hogs[i]));
+  }
+
+  printf("duration: %u ms\n", duration);
+  printf("throughput: %.2f acquisitions/s\n",
+         (double)acquisitions * 1000.0 / (double)duration);
+  printf("high priority latency: avg %.2f ms, max %u ms (%u samples)\n",
+         numLatency ? (double)totalLatency / (double)numLatency : 0.0,
+         maxLatency, numLatency);
+  printf("spin limit: %d, spins: %u, acquired spinning: %u, suspends: %u, "
+         "hold avg: %llu ns\n",
+         m.spin_limit, m.num_spins, m.num_spin_acquires, m.num_suspends,
+         m.hold_avg);
+
+  mutex_destroy(&m);
+
+  task_exit(0);
+}
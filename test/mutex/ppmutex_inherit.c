@@ -0,0 +1,101 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppmutex_inherit.c
+ * Description: Test of the priority inheritance of the mutex. A task waits for
+ * a mutex whose owner waits for another one, and when the priority of the
+ * waiting task changes, either up or down, the whole chain of owners must
+ * inherit the new priority.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define PRIO (10)
+
+task_t top, mid, waiter;
+mutex_t m1, m2;
+semaphore_t go;
+int errors = 0;
+
+void topBody(void *arg) {
+  mutex_lock(&m1);
+  sem_down(&go);
+  mutex_unlock(&m1);
+  task_exit(0);
+}
+
+void midBody(void *arg) {
+  mutex_lock(&m2);
+  mutex_lock(&m1);
+  mutex_unlock(&m1);
+  mutex_unlock(&m2);
+  task_exit(0);
+}
+
+void waiterBody(void *arg) {
+  mutex_lock(&m2);
+  mutex_unlock(&m2);
+  task_exit(0);
+}
+
+/**
+ * Checks the priority inherited by the owners in the chain.
+ */
+void check(const char *name, int prio) {
+  printf("%5d ms: main: %s: prioridades %d e %d, esperada %d\n", systime(),
+         name, mid.initial_priority, top.initial_priority, prio);
+  if (mid.initial_priority != prio || top.initial_priority != prio) {
+    errors++;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  mutex_init(&m1);
+  mutex_init(&m2);
+  sem_init(&go, 0);
+
+  task_init(&top, topBody, NULL);
+  task_setprio(&top, PRIO);
+  task_init(&mid, midBody, NULL);
+  task_setprio(&mid, PRIO);
+  task_sleep(10);
+
+  // Started once the chain of owners is formed
+  task_init(&waiter, waiterBody, NULL);
+  task_setprio(&waiter, PRIO / 2);
+  task_sleep(10);
+  check("herdada", PRIO / 2);
+
+  task_setprio(&waiter, -PRIO);
+  check("aumentada", -PRIO);
+
+  task_setprio(&waiter, 2 * PRIO);
+  check("reduzida", PRIO);
+
+  sem_up(&go);
+  task_wait(&top);
+  task_wait(&mid);
+  task_wait(&waiter);
+
+  mutex_destroy(&m1);
+  mutex_destroy(&m2);
+  sem_destroy(&go);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
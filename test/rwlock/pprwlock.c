@@ -0,0 +1,117 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: pprwlock.c
+ * Description: Test of the reader-writer locks. The writers update a table
+ * entry by entry, while the readers verify that they never see a table half
+ * updated, with both preferences of the lock.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+
+#define NUMREADERS (6)
+#define NUMWRITERS (2)
+#define NUMSTEPS (300)
+#define TABLESIZE (64)
+
+task_t readers[NUMREADERS], writers[NUMWRITERS];
+rwlock_t rw;
+
+int table[TABLESIZE];
+int activeReaders = 0, maxReaders = 0;
+int errors = 0;
+
+void readerBody(void *arg) {
+  for (int i = 0; i < NUMSTEPS; i++) {
+    rwlock_rdlock(&rw);
+    activeReaders++;
+    if (activeReaders > maxReaders) {
+      maxReaders = activeReaders;
+    }
+
+    for (int j = 0; j < TABLESIZE; j++) {
+      if (table[j] != table[0]) {
+        errors++;
+        break;
+      }
+
+      // Gives the other tasks a chance to enter the critical section
+      if (j == TABLESIZE / 2) {
+        task_yield();
+      }
+    }
+
+    activeReaders--;
+    rwlock_unlock(&rw);
+  }
+
+  task_exit(0);
+}
+
+void writerBody(void *arg) {
+  for (int i = 0; i < NUMSTEPS / 10; i++) {
+    rwlock_wrlock(&rw);
+    if (activeReaders) {
+      errors++;
+    }
+
+    for (int j = 0; j < TABLESIZE; j++) {
+      table[j]++;
+      if (j == TABLESIZE / 2) {
+        task_yield();
+      }
+    }
+    rwlock_unlock(&rw);
+    task_yield();
+  }
+
+  task_exit(0);
+}
+
+void run(rwlock_pref pref, char *name) {
+  rwlock_init(&rw, pref);
+  maxReaders = 0;
+
+  for (int i = 0; i < NUMREADERS; i++) {
+    task_init(&(readers[i]), readerBody, NULL);
+  }
+
+  for (int i = 0; i < NUMWRITERS; i++) {
+    task_init(&(writers[i]), writerBody, NULL);
+  }
+
+  for (int i = 0; i < NUMREADERS; i++) {
+    task_wait(&(readers[i]));
+  }
+
+  for (int i = 0; i < NUMWRITERS; i++) {
+    task_wait(&(writers[i]));
+  }
+
+  rwlock_destroy(&rw);
+  printf("%s: ate %d leitores ao mesmo tempo, %d erros\n", name, maxReaders,
+         errors);
+}
+
+int main(int argc, char *argv[]) {
+  printf("main: inicio\n");
+  ppos_init();
+
+  run(RW_PREFER_READERS, "leitores");
+  run(RW_PREFER_WRITERS, "escritores");
+
+  if (errors == 0 && table[0] == 2 * NUMWRITERS * (NUMSTEPS / 10)) {
+    printf("Tabela correta!\n");
+  } else {
+    printf("Tabela errada!\n");
+    task_exit(1);
+  }
+
+  printf("main: fim\n");
+  task_exit(0);
+}
@@ -0,0 +1,129 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppbudget.c
+ * Description: Test of the reservations of processor. A runaway task with the
+ * highest priority must only use the processor time of its budget, leaving the
+ * rest to a task with a lower priority, two tasks sharing a budget must use
+ * its processor time together, leaving the processor idle for the rest of the
+ * period, and the throttling must be counted.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define RUNTIME (5)
+#define PERIOD (20)
+#define WINDOW (400)
+#define TOLERANCE (0.05)
+
+task_t runaway, other, group[2];
+cpu_budget_t single, shared;
+unsigned long long windowStart = 0;
+volatile int stop = 0;
+int errors = 0;
+
+void hogBody(void *arg) {
+  while (!stop) {
+  }
+
+  task_exit(0);
+}
+
+/**
+ * Gets the share of the processor that a task used since the window started.
+ *
+ * The window is measured by the clock instead of the ticks, as the ticks that
+ * are late are counted only once.
+ */
+double share(task_t *task) {
+  task_times_t times;
+  task_times(task, &times);
+  return (double)times.run / (double)(systime_ns() - windowStart);
+}
+
+/**
+ * Checks the share of the processor used against the share reserved.
+ */
+void check(const char *name, double used, double reserved,
+           cpu_budget_t *budget) {
+  printf("%5d ms: main: %s: %.1f%% do processador, reservado %.1f%%, %u "
+         "periodos esgotados, %u estrangulamentos\n",
+         systime(), name, 100.0 * used, 100.0 * reserved, budget->num_depleted,
+         budget->num_throttles);
+  if (used > reserved + TOLERANCE || used < reserved - TOLERANCE
+      || budget->num_depleted == 0 || budget->num_throttles == 0) {
+    errors++;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  if (cpu_budget_init(&single, PERIOD, RUNTIME) == 0
+      || cpu_budget_init(&single, 0, PERIOD) == 0
+      || cpu_budget_init(&single, RUNTIME, PERIOD) < 0) {
+    errors++;
+  }
+
+  // A runaway task with the highest priority
+  task_init(&runaway, hogBody, NULL);
+  task_setprio(&runaway, TASK_MIN_PRIO);
+  cpu_budget_attach(&single, &runaway);
+  task_init(&other, hogBody, NULL);
+  task_setprio(&other, TASK_MAX_PRIO);
+
+  windowStart = systime_ns();
+  task_sleep(WINDOW);
+  stop = 1;
+  double runawayShare = share(&runaway);
+  double otherShare = share(&other);
+  task_wait(&runaway);
+  task_wait(&other);
+
+  check("tarefa", runawayShare, (double)RUNTIME / PERIOD, &single);
+  if (otherShare < 1.0 - (double)RUNTIME / PERIOD - TOLERANCE) {
+    errors++;
+  }
+
+  if (single.num_tasks != 0 || cpu_budget_destroy(&single) < 0) {
+    errors++;
+  }
+
+  // Two tasks sharing a budget, alone in the system
+  stop = 0;
+  cpu_budget_init(&shared, 2 * RUNTIME, PERIOD);
+  for (int i = 0; i < 2; i++) {
+    task_init(&(group[i]), hogBody, NULL);
+    cpu_budget_attach(&shared, &(group[i]));
+  }
+
+  if (cpu_budget_destroy(&shared) == 0) {
+    errors++;
+  }
+
+  windowStart = systime_ns();
+  task_sleep(WINDOW);
+  stop = 1;
+  double groupShare = share(&(group[0])) + share(&(group[1]));
+  for (int i = 0; i < 2; i++) {
+    task_wait(&(group[i]));
+  }
+
+  check("grupo", groupShare, 2.0 * RUNTIME / PERIOD, &shared);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
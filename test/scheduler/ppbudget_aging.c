@@ -0,0 +1,111 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppbudget_aging.c
+ * Description: Test of the aging across the throttling of a group of tasks. The
+ * tasks of a group whose budget is depleted are parked when the processor is
+ * given, and the ready tasks must still age once for each task executed, so an
+ * observer task keeps the priority expected from the number of dispatches.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMHOGS (4)
+#define RUNTIME (2)
+#define PERIOD (20)
+#define WINDOW (100)
+
+task_t group[NUMHOGS], filler, observer;
+cpu_budget_t shared;
+volatile int stop = 0;
+int excess = 0;
+int errors = 0;
+
+void hogBody(void *arg) {
+  while (!stop) {
+  }
+
+  task_exit(0);
+}
+
+/**
+ * Gets the number of times the processor was given to the tasks that can
+ * execute before the observer.
+ */
+int dispatches(void) {
+  int total = (int)filler.num_calls;
+  for (int i = 0; i < NUMHOGS; i++) {
+    total += (int)group[i].num_calls;
+  }
+
+  return total;
+}
+
+/**
+ * Compares the aging of the observer, while it waits for the processor, with
+ * the number of tasks executed since it was created. The priority is read
+ * first, so a dispatch in between can only increase the second one.
+ */
+void fillerBody(void *arg) {
+  while (!stop) {
+    if (observer.num_calls != 0) {
+      continue;
+    }
+
+    int aged = TASK_MAX_PRIO - observer.current_priority;
+    int executed = dispatches();
+    if (aged - executed > excess) {
+      excess = aged - executed;
+    }
+  }
+
+  task_exit(0);
+}
+
+void observerBody(void *arg) { task_exit(0); }
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  cpu_budget_init(&shared, RUNTIME, PERIOD);
+  for (int i = 0; i < NUMHOGS; i++) {
+    task_init(&(group[i]), hogBody, NULL);
+    cpu_budget_attach(&shared, &(group[i]));
+  }
+
+  task_init(&filler, fillerBody, NULL);
+  task_setprio(&filler, TASK_MAX_PRIO / 2);
+  task_init(&observer, observerBody, NULL);
+  task_setprio(&observer, TASK_MAX_PRIO);
+
+  task_sleep(WINDOW);
+  stop = 1;
+
+  printf("%5d ms: main: %u estrangulamentos, envelhecimento excedente %d\n",
+         systime(), shared.num_throttles, excess);
+  if (shared.num_throttles == 0 || excess != 0) {
+    errors++;
+  }
+
+  for (int i = 0; i < NUMHOGS; i++) {
+    task_wait(&(group[i]));
+  }
+  task_wait(&filler);
+  task_wait(&observer);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
@@ -0,0 +1,162 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppedf.c
+ * Description: Test of the real-time class. Periodic tasks must meet their
+ * deadlines while a time-sharing task with the highest priority uses the
+ * processor, a task that consumes more than its budget is throttled, and a
+ * task that ends its jobs late has the misses counted.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMJOBS (20)
+
+typedef struct periodic_t {
+  const char *name;
+  int period, deadline, budget;
+
+  // Processor time used by each job, in milliseconds
+  int work;
+
+  // Time slept by each job, in milliseconds
+  int sleep;
+
+  task_t task;
+  task_rt_stats_t stats;
+} periodic_t;
+
+periodic_t periodic[] = {
+    {.name = "fast", .period = 10, .deadline = 10, .budget = 3, .work = 1},
+    {.name = "slow", .period = 20, .deadline = 15, .budget = 5, .work = 2},
+    {.name = "greedy", .period = 10, .deadline = 10, .budget = 2, .work = 8},
+    {.name = "late", .period = 20, .deadline = 5, .budget = 5, .sleep = 8},
+};
+
+#define NUMPERIODIC (int)(sizeof(periodic) / sizeof(periodic[0]))
+
+task_t hog;
+int stop = 0;
+long hogLoops = 0;
+int errors = 0;
+
+/**
+ * Keeps the processor busy until the task executed for a number of
+ * milliseconds.
+ */
+void work(int time) {
+  task_times_t start, now;
+  task_times(NULL, &start);
+  do {
+    for (volatile int i = 0; i < 1000; i++) {
+    }
+    task_times(NULL, &now);
+  } while (now.run - start.run < time * 1000000ULL);
+}
+
+void periodicBody(void *arg) {
+  periodic_t *p = (periodic_t *)arg;
+
+  if (task_set_periodic(p->period, p->deadline, p->budget) < 0) {
+    errors++;
+    task_exit(1);
+  }
+
+  for (int i = 0; i < NUMJOBS; i++) {
+    work(p->work);
+    if (p->sleep) {
+      task_sleep(p->sleep);
+    }
+
+    if (task_wait_period() < 0) {
+      errors++;
+    }
+  }
+
+  task_rt_stats(NULL, &(p->stats));
+  task_exit(0);
+}
+
+void hogBody(void *arg) {
+  while (!stop) {
+    hogLoops++;
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  task_init(&hog, hogBody, NULL);
+  task_setprio(&hog, TASK_MIN_PRIO);
+
+  for (int i = 0; i < NUMPERIODIC; i++) {
+    task_init(&(periodic[i].task), periodicBody, &(periodic[i]));
+  }
+
+  for (int i = 0; i < NUMPERIODIC; i++) {
+    task_wait(&(periodic[i].task));
+  }
+
+  stop = 1;
+  task_wait(&hog);
+
+  for (int i = 0; i < NUMPERIODIC; i++) {
+    periodic_t *p = &(periodic[i]);
+    printf("%5d ms: main: %s: %u jobs, %u perdidos, %u estouros\n", systime(),
+           p->name, p->stats.jobs, p->stats.misses, p->stats.throttles);
+
+    if (p->stats.jobs != NUMJOBS) {
+      errors++;
+    }
+  }
+
+  // The time-sharing task does not delay the real-time ones
+  if (periodic[0].stats.misses || periodic[1].stats.misses
+      || periodic[0].stats.throttles || periodic[1].stats.throttles) {
+    errors++;
+  }
+
+  // Each job needs several times its budget
+  if (periodic[2].stats.throttles < NUMJOBS) {
+    errors++;
+  }
+
+  // Every job sleeps past its deadline
+  if (periodic[3].stats.misses != NUMJOBS) {
+    errors++;
+  }
+
+  // The time-sharing task used the processor left
+  if (hogLoops == 0) {
+    errors++;
+  }
+
+  // Invalid parameters, and tasks out of the real-time class
+  task_rt_stats_t stats;
+  if (task_set_periodic(10, 20, 5) == 0 || task_set_periodic(10, 5, 8) == 0
+      || task_set_periodic(0, 5, 5) == 0) {
+    errors++;
+  }
+
+  if (task_wait_period() == 0 || task_rt_stats(&hog, &stats) == 0) {
+    errors++;
+  }
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
@@ -0,0 +1,99 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: pppreempt.c
+ * Description: Test of the regions where the preemption is disabled. Another
+ * task must not execute inside the region, even after the quantum expired, the
+ * regions must nest, and the tick deferred meanwhile must preempt the task as
+ * soon as the region is over.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define REGION (3 * TASK_QUANTUM) // In milliseconds
+
+task_t other;
+volatile long count = 0;
+int stop = 0;
+int errors = 0;
+
+/**
+ * Keeps the processor busy for a number of milliseconds.
+ */
+void busy(int time) {
+  unsigned long long start = systime_ns();
+  while (systime_ns() - start < time * 1000000ULL) {
+  }
+}
+
+void otherBody(void *arg) {
+  while (!stop) {
+    count++;
+  }
+
+  task_exit(0);
+}
+
+/**
+ * Executes a region with the preemption disabled, nested a number of times,
+ * and checks that the other task only executed once it was over.
+ */
+void region(int nesting, const char *name) {
+  for (int i = 0; i < nesting; i++) {
+    preempt_disable();
+  }
+
+  long before = count;
+  busy(REGION);
+  for (int i = 1; i < nesting; i++) {
+    preempt_enable();
+  }
+
+  // Still disabled by the outermost call
+  busy(REGION);
+  long inside = count - before;
+
+  preempt_enable();
+  long after = count - before;
+
+  printf("%5d ms: main: %s: %ld dentro, %ld depois\n", systime(), name, inside,
+         after);
+  if (inside != 0 || after == 0) {
+    errors++;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  task_init(&other, otherBody, NULL);
+
+  // Lets the other task start
+  task_sleep(10);
+
+  region(1, "simples");
+  region(3, "aninhada");
+
+  if (preempt_enable() == 0) {
+    errors++;
+  }
+
+  stop = 1;
+  task_wait(&other);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
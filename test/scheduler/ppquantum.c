@@ -0,0 +1,127 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppquantum.c
+ * Description: Test of the quantum sizing. Two CPU-bound tasks with the same
+ * priority share the processor, one with the quantum of its priority in the
+ * quantum table and the other with its own quantum, and each one must execute
+ * for its quantum before leaving the processor.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define PRIO (10)
+#define FIXED (10)
+#define RUNTIME (500)
+#define TOLERANCE (3)
+
+typedef struct hog_t {
+  const char *name;
+  task_t task;
+
+  // Longest time executing without leaving the processor, in milliseconds
+  unsigned int slice;
+} hog_t;
+
+hog_t table = {.name = "tabela"}, fixed = {.name = "fixo"};
+int quanta[QUANTUM_LEVELS];
+volatile int stop = 0;
+int errors = 0;
+
+void hogBody(void *arg) {
+  hog_t *hog = (hog_t *)arg;
+  unsigned long long last = systime_ns();
+  unsigned long long start = last;
+
+  while (!stop) {
+    // A gap in the clock means the task left the processor
+    unsigned long long now = systime_ns();
+    if (now - last > 500000ULL) {
+      if ((last - start) / 1000000ULL > hog->slice) {
+        hog->slice = (unsigned int)((last - start) / 1000000ULL);
+      }
+      start = now;
+    }
+    last = now;
+  }
+
+  task_exit(0);
+}
+
+/**
+ * Checks the longest slice of a task against its quantum.
+ */
+void check(hog_t *hog, int quantum) {
+  printf("%5d ms: main: %s: executou %u ms de %d ms\n", systime(), hog->name,
+         hog->slice, quantum);
+  if (hog->slice + TOLERANCE < (unsigned int)quantum
+      || hog->slice > (unsigned int)(quantum + TOLERANCE)) {
+    errors++;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  if (task_get_quantum(NULL) != TASK_QUANTUM) {
+    errors++;
+  }
+
+  // The quantum grows as the priority gets lower
+  for (int i = 0; i < QUANTUM_LEVELS; i++) {
+    quanta[i] = TASK_QUANTUM / 2 + i;
+  }
+
+  if (task_set_quantum_table(quanta) < 0) {
+    errors++;
+  }
+
+  task_init(&(table.task), hogBody, &table);
+  task_setprio(&(table.task), PRIO);
+  task_init(&(fixed.task), hogBody, &fixed);
+  task_setprio(&(fixed.task), PRIO);
+  task_set_quantum(&(fixed.task), FIXED);
+
+  int quantum = quanta[PRIO - TASK_MIN_PRIO];
+  if (task_get_quantum(&(table.task)) != quantum
+      || task_get_quantum(&(fixed.task)) != FIXED) {
+    errors++;
+  }
+
+  task_sleep(RUNTIME);
+  stop = 1;
+  task_wait(&(table.task));
+  task_wait(&(fixed.task));
+
+  check(&table, quantum);
+  check(&fixed, FIXED);
+
+  // Back to the quantum of the priority, and to the default table
+  task_set_quantum(&(fixed.task), 0);
+  if (task_get_quantum(&(fixed.task)) != quantum) {
+    errors++;
+  }
+
+  quanta[0] = 0;
+  if (task_set_quantum_table(quanta) == 0 || task_set_quantum(NULL, -1) == 0
+      || task_set_quantum_table(NULL) < 0
+      || task_get_quantum(&(fixed.task)) != TASK_QUANTUM) {
+    errors++;
+  }
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
@@ -0,0 +1,175 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppwakeup.c
+ * Description: Test of the wakeup preemption. A task awakened with a priority
+ * higher than the executing one by more than the gap must execute right away,
+ * either awakened by another task or once its sleep is over, even within its
+ * slack together with a task that does not preempt, a task within the gap must
+ * wait, and a region without preemption must defer the switch until it is
+ * over.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define PRIO (-10)
+#define SLEEPTIME (5)
+
+task_t waiter, sleeper, other;
+task_t *queue = NULL;
+volatile int ran = 0;
+volatile unsigned int awake = 0;
+int stop = 0;
+int errors = 0;
+
+/**
+ * Keeps the processor busy for a number of milliseconds.
+ */
+void busy(int time) {
+  unsigned long long start = systime_ns();
+  while (systime_ns() - start < time * 1000000ULL) {
+  }
+}
+
+void waiterBody(void *arg) {
+  while (1) {
+    task_suspend(&queue);
+    if (stop) {
+      break;
+    }
+
+    ran++;
+  }
+
+  task_exit(0);
+}
+
+void sleeperBody(void *arg) {
+  task_sleep(SLEEPTIME);
+  awake = systime();
+  task_exit(0);
+}
+
+void otherBody(void *arg) {
+  task_sleep(SLEEPTIME + 1);
+  task_exit(0);
+}
+
+/**
+ * Awakes the waiter, and checks if it executed before returning.
+ */
+void awakeCheck(const char *name, int expected) {
+  int before = ran;
+  task_awake(&waiter, &queue);
+  int after = ran;
+
+  printf("%5d ms: main: %s: %s\n", systime(), name,
+         after != before ? "executou" : "esperou");
+  if ((after != before) != expected) {
+    errors++;
+  }
+
+  // Lets the waiter execute if it did not
+  task_sleep(1);
+}
+
+/**
+ * Sleeps a task while the main task uses the processor, and checks if it
+ * executed once it was awakened. With slack, the task is only awakened with
+ * another one, that does not preempt the main task.
+ */
+void sleepCheck(const char *name, int slack, int expected) {
+  awake = 0;
+  task_init(&sleeper, sleeperBody, NULL);
+  task_setprio(&sleeper, PRIO);
+  if (slack) {
+    task_set_slack(&sleeper, 3 * SLEEPTIME);
+    task_init(&other, otherBody, NULL);
+    task_setprio(&other, PRIO / 2);
+  }
+
+  // Starts with a whole quantum, after the sleeper went to sleep
+  task_yield();
+  unsigned int start = systime();
+  busy(3 * SLEEPTIME);
+  unsigned int wakeup = awake;
+
+  printf("%5d ms: main: %s: acordou apos %d ms\n", systime(), name,
+         wakeup ? (int)(wakeup - start) : -1);
+  if ((wakeup != 0) != expected
+      || (expected && wakeup - start > SLEEPTIME + 2)) {
+    errors++;
+  }
+
+  task_wait(&sleeper);
+  if (slack) {
+    task_wait(&other);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  task_init(&waiter, waiterBody, NULL);
+  task_setprio(&waiter, PRIO);
+  task_sleep(1);
+
+  awakeCheck("prioridade maior", 1);
+
+  preempt_disable();
+  int before = ran;
+  task_awake(&waiter, &queue);
+  int inside = ran - before;
+  preempt_enable();
+  printf("%5d ms: main: sem preempcao: %d dentro, %d depois\n", systime(),
+         inside, ran - before);
+  if (inside != 0 || ran - before != 1) {
+    errors++;
+  }
+
+  sleepCheck("prioridade maior", 0, 1);
+
+  // Only the sleeper is higher by more than the gap
+  task_set_wakeup_gap(-PRIO / 2);
+  sleepCheck("com folga", 1, 1);
+
+  // The gap is larger than the difference between the priorities
+  if (task_set_wakeup_gap(-PRIO) < 0) {
+    errors++;
+  }
+  awakeCheck("dentro do intervalo", 0);
+  sleepCheck("dentro do intervalo", 0, 0);
+
+  // The same priority preempts
+  task_setprio(&waiter, 0);
+  task_set_wakeup_gap(-1);
+  awakeCheck("mesma prioridade", 1);
+
+  task_set_wakeup_gap(0);
+  awakeCheck("mesma prioridade sem intervalo", 0);
+
+  if (task_set_wakeup_gap(-2) == 0
+      || task_set_wakeup_gap(TASK_MAX_PRIO - TASK_MIN_PRIO + 1) == 0) {
+    errors++;
+  }
+
+  stop = 1;
+  task_awake(&waiter, &queue);
+  task_wait(&waiter);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
@@ -0,0 +1,123 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppwakeup_bench.c
+ * Description: Latency benchmark of the wakeup preemption. An interactive task
+ * with a high priority competes with CPU-bound tasks, once awakened by one of
+ * them and once sleeping, and reports the time from each wakeup until the task
+ * executed, without the wakeup preemption and with it.
+ * Usage: WakeupBench [CPU-bound tasks] [rounds]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUMHOGS (4)
+#define MAXHOGS (100)
+#define NUMROUNDS (200)
+#define INTERVAL (2000000ULL)  // Between the wakeups, in nanoseconds
+#define SLEEPTIME (2000000ULL) // In nanoseconds
+
+task_t hogs[MAXHOGS], interactive;
+task_t *queue = NULL;
+unsigned long long latency[NUMROUNDS];
+unsigned long long awakenAt = 0;
+int numHogs = NUMHOGS;
+int numRounds = NUMROUNDS;
+volatile int stop = 0;
+
+/**
+ * The first CPU-bound task also awakes the interactive one, once in a while.
+ */
+void hogBody(void *arg) {
+  int waker = (arg != NULL);
+  unsigned long long next = systime_ns() + INTERVAL;
+
+  while (!stop) {
+    if (waker && queue && systime_ns() >= next) {
+      awakenAt = systime_ns();
+      next = awakenAt + INTERVAL;
+      task_awake(&interactive, &queue);
+    }
+  }
+
+  task_exit(0);
+}
+
+void awakenBody(void *arg) {
+  for (int i = 0; i < numRounds; i++) {
+    task_suspend(&queue);
+    latency[i] = systime_ns() - awakenAt;
+  }
+
+  stop = 1;
+  task_exit(0);
+}
+
+void sleepBody(void *arg) {
+  for (int i = 0; i < numRounds; i++) {
+    unsigned long long deadline = systime_ns() + SLEEPTIME;
+    task_sleep_until(deadline);
+    latency[i] = systime_ns() - deadline;
+  }
+
+  stop = 1;
+  task_exit(0);
+}
+
+int compare(const void *ptr1, const void *ptr2) {
+  unsigned long long a = *(const unsigned long long *)ptr1;
+  unsigned long long b = *(const unsigned long long *)ptr2;
+  return (a > b) - (a < b);
+}
+
+void run(void (*body)(void *), const char *name) {
+  stop = 0;
+  for (long i = 0; i < numHogs; i++) {
+    task_init(&(hogs[i]), hogBody, i == 0 ? (void *)1 : NULL);
+  }
+
+  task_init(&interactive, body, NULL);
+  task_setprio(&interactive, -10);
+
+  task_wait(&interactive);
+  for (int i = 0; i < numHogs; i++) {
+    task_wait(&(hogs[i]));
+  }
+
+  qsort(latency, (size_t)numRounds, sizeof(latency[0]), compare);
+  printf("%s: median %llu us, p99 %llu us, max %llu us\n", name,
+         latency[numRounds / 2] / 1000, latency[numRounds * 99 / 100] / 1000,
+         latency[numRounds - 1] / 1000);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 0 && atoi(argv[1]) <= MAXHOGS) {
+    numHogs = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) > 0 && atoi(argv[2]) <= NUMROUNDS) {
+    numRounds = atoi(argv[2]);
+  }
+
+  ppos_init();
+  task_setprio(NULL, -20);
+
+  printf("CPU-bound tasks: %d, rounds: %d\n", numHogs, numRounds);
+
+  task_set_wakeup_gap(TASK_MAX_PRIO - TASK_MIN_PRIO);
+  run(awakenBody, "awakened, without preemption");
+  run(sleepBody, "sleeping, without preemption");
+
+  task_set_wakeup_gap(0);
+  run(awakenBody, "awakened, with preemption");
+  run(sleepBody, "sleeping, with preemption");
+
+  task_exit(0);
+}
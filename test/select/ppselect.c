@@ -0,0 +1,186 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppselect.c
+ * Description: Test of ppos_select. A single task serves three message queues
+ * and a semaphore, each one fed by its own task at a different pace, without
+ * a relay task per queue. A semaphore whose units are reserved for a waiting
+ * task must not be ready.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+
+#define NUMQUEUES (3)
+#define NUMMSGS (50)
+#define NUMTICKS (20)
+
+task_t producers[NUMQUEUES], ticker, server, bulk, selector;
+mqueue_t queues[NUMQUEUES], count;
+semaphore_t tick, reserved;
+
+long int received[NUMQUEUES];
+int ticks = 0;
+volatile int selected = 0;
+int errors = 0;
+
+void producerBody(void *arg) {
+  int id = (int)(long)arg;
+
+  for (int i = 1; i <= NUMMSGS; i++) {
+    if (mqueue_send(&(queues[id]), &i) < 0) {
+      errors++;
+    }
+    task_sleep(id * 3 + 1);
+  }
+
+  task_exit(0);
+}
+
+void tickerBody(void *arg) {
+  for (int i = 0; i < NUMTICKS; i++) {
+    task_sleep(7);
+    sem_up(&tick);
+  }
+
+  task_exit(0);
+}
+
+void bulkBody(void *arg) {
+  sem_down_n(&reserved, 2);
+  task_exit(0);
+}
+
+void selectorBody(void *arg) {
+  select_t set[1];
+  set[0].type = SELECT_SEM;
+  set[0].object = &reserved;
+
+  if (ppos_select(set, 1) != 1 || set[0].ready != 1) {
+    errors++;
+  }
+  selected = 1;
+  sem_down(&reserved);
+  task_exit(0);
+}
+
+void serverBody(void *arg) {
+  select_t set[NUMQUEUES + 1];
+  int msgs = 0;
+
+  for (int i = 0; i < NUMQUEUES; i++) {
+    set[i].type = SELECT_MQUEUE;
+    set[i].object = &(queues[i]);
+  }
+  set[NUMQUEUES].type = SELECT_SEM;
+  set[NUMQUEUES].object = &tick;
+
+  while (msgs < NUMQUEUES * NUMMSGS || ticks < NUMTICKS) {
+    if (ppos_select(set, NUMQUEUES + 1) <= 0) {
+      errors++;
+      break;
+    }
+
+    for (int i = 0; i < NUMQUEUES; i++) {
+      if (set[i].ready > 0) {
+        int value;
+        mqueue_recv(&(queues[i]), &value);
+        received[i] += value;
+        msgs++;
+      }
+    }
+
+    if (set[NUMQUEUES].ready > 0) {
+      sem_down(&tick);
+      ticks++;
+    }
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  // The count of messages follows the sends and receives
+  mqueue_init(&count, 5, sizeof(int));
+  for (int i = 0; i < 3; i++) {
+    mqueue_send(&count, &i);
+  }
+
+  if (mqueue_msgs(&count) != 3) {
+    printf("%5d ms: main: mqueue_msgs %d, deveria ser 3\n", systime(),
+           mqueue_msgs(&count));
+    errors++;
+  }
+
+  int value;
+  mqueue_recv(&count, &value);
+  if (mqueue_msgs(&count) != 2) {
+    printf("%5d ms: main: mqueue_msgs %d, deveria ser 2\n", systime(),
+           mqueue_msgs(&count));
+    errors++;
+  }
+  mqueue_destroy(&count);
+
+  // The unit released is reserved for the task waiting for two of them, and
+  // only the one left after it got its units can be selected
+  sem_init(&reserved, 0);
+  task_init(&bulk, bulkBody, NULL);
+  task_sleep(5);
+  task_init(&selector, selectorBody, NULL);
+  sem_up(&reserved);
+  task_sleep(5);
+  if (selected) {
+    printf("%5d ms: main: unidade reservada foi selecionada\n", systime());
+    errors++;
+  }
+
+  sem_up_n(&reserved, 2);
+  task_sleep(5);
+  if (!selected) {
+    printf("%5d ms: main: unidade livre nao foi selecionada\n", systime());
+    errors++;
+  }
+  task_wait(&bulk);
+  task_wait(&selector);
+  sem_destroy(&reserved);
+
+  for (int i = 0; i < NUMQUEUES; i++) {
+    mqueue_init(&(queues[i]), 5, sizeof(int));
+  }
+  sem_init(&tick, 0);
+
+  task_init(&server, serverBody, NULL);
+  for (long i = 0; i < NUMQUEUES; i++) {
+    task_init(&(producers[i]), producerBody, (void *)i);
+  }
+  task_init(&ticker, tickerBody, NULL);
+
+  task_wait(&server);
+
+  for (int i = 0; i < NUMQUEUES; i++) {
+    task_wait(&(producers[i]));
+    printf("%5d ms: main: fila %d recebeu %ld\n", systime(), i, received[i]);
+    if (received[i] != NUMMSGS * (NUMMSGS + 1) / 2) {
+      errors++;
+    }
+    mqueue_destroy(&(queues[i]));
+  }
+  task_wait(&ticker);
+  sem_destroy(&tick);
+
+  printf("%5d ms: main: %d ticks, %d erros\n", systime(), ticks, errors);
+  if (errors || ticks != NUMTICKS) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
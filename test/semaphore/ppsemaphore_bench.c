@@ -0,0 +1,87 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppsemaphore_bench.c
+ * Description: Contention benchmark for the semaphore. Reports how many times
+ * the tasks were awakened for each unit acquired.
+ * Usage: SemaphoreBench [steps] [spin limit] [tasks]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUMTASKS (30)
+#define NUMSTEPS (100000)
+
+task_t task[NUMTASKS];
+semaphore_t s;
+long int soma = 0;
+int numSteps = NUMSTEPS;
+int numTasks = NUMTASKS;
+
+void taskBody(void *id) {
+  for (int i = 0; i < numSteps; i++) {
+    sem_down(&s);
+    soma += 1;
+    sem_up(&s);
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1) {
+    numSteps = atoi(argv[1]);
+  }
+
+  ppos_init();
+  sem_init(&s, 0);
+
+  if (argc > 2) {
+    sem_spin(&s, atoi(argv[2]));
+  }
+
+  if (argc > 3 && atoi(argv[3]) > 0 && atoi(argv[3]) < NUMTASKS) {
+    numTasks = atoi(argv[3]);
+  }
+
+  for (int i = 0; i < numTasks; i++) {
+    task_init(&(task[i]), taskBody, NULL);
+  }
+
+  // Let every task pile up in the semaphore before releasing it
+  task_sleep(20);
+  unsigned int start = systime();
+  sem_up(&s);
+
+  for (int i = 0; i < numTasks; i++) {
+    task_wait(&(task[i]));
+  }
+
+  unsigned int elapsed = systime() - start;
+
+  printf("tasks: %d, steps: %d, time: %u ms\n", numTasks, numSteps, elapsed);
+  printf("acquisitions: %u, suspends: %u, wakeups: %u\n", s.num_acquires,
+         s.num_suspends, s.num_wakeups);
+  printf("wakeups per acquisition: %.4f\n",
+         (double)s.num_wakeups / (double)s.num_acquires);
+  printf("suspends per acquisition: %.4f\n",
+         (double)s.num_suspends / (double)s.num_acquires);
+  printf("spin limit: %d, spins: %u, acquired spinning: %u, hold avg: %llu ns\n",
+         s.spin_limit, s.num_spins, s.num_spin_acquires, s.hold_avg);
+
+  sem_destroy(&s);
+
+  if (soma != (long)numSteps * numTasks) {
+    printf("sum %ld, should be %ld\n", soma, (long)numSteps * numTasks);
+    task_exit(1);
+  }
+
+  task_exit(0);
+}
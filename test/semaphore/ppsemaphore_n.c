@@ -0,0 +1,184 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppsemaphore_n.c
+ * Description: Test of sem_up_n and sem_down_n. Tasks take chunks of a pool
+ * with a fixed capacity, and the pool must never be overcommitted. A single
+ * sem_up_n must also wake every waiter that can proceed, and the units released
+ * while a task waits must go to it, not to the task that released them. A task
+ * waiting for the whole pool must not starve while other tasks keep taking
+ * single units.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMTASKS (8)
+#define NUMSTEPS (2000)
+#define CAPACITY (10)
+#define NUMTAKERS (3)
+
+task_t task[NUMTASKS];
+semaphore_t pool, gate, hand, stream;
+int inUse = 0, maxInUse = 0;
+int awake = 0;
+int order[2], numOrder = 0;
+int taken = 0, passed = -1;
+int errors = 0;
+
+void poolBody(void *arg) {
+  int chunk = (int)(long)arg % 5 + 1;
+
+  for (int i = 0; i < NUMSTEPS; i++) {
+    if (sem_down_n(&pool, chunk) < 0) {
+      errors++;
+    }
+
+    inUse += chunk;
+    if (inUse > maxInUse) {
+      maxInUse = inUse;
+    }
+
+    if (i % 3 == 0) {
+      task_yield();
+    }
+
+    inUse -= chunk;
+    sem_up_n(&pool, chunk);
+  }
+
+  task_exit(0);
+}
+
+void gateBody(void *arg) {
+  sem_down_n(&gate, 2);
+  awake++;
+  task_exit(0);
+}
+
+void handBody(void *arg) {
+  if (sem_down(&hand) < 0) {
+    errors++;
+  }
+  order[numOrder++] = 1;
+  sem_up(&hand);
+  task_exit(0);
+}
+
+void takerBody(void *arg) {
+  for (int i = 0; i < NUMSTEPS; i++) {
+    sem_down(&stream);
+    taken++;
+    task_yield();
+    sem_up(&stream);
+  }
+
+  task_exit(0);
+}
+
+void bulkBody(void *arg) {
+  int before = taken;
+  sem_down_n(&stream, NUMTAKERS);
+  passed = taken - before;
+  sem_up_n(&stream, NUMTAKERS);
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  sem_init(&pool, CAPACITY);
+  for (long i = 0; i < NUMTASKS; i++) {
+    task_init(&(task[i]), poolBody, (void *)i);
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_wait(&(task[i]));
+  }
+
+  printf("%5d ms: main: uso maximo %d de %d\n", systime(), maxInUse, CAPACITY);
+  if (maxInUse > CAPACITY || inUse != 0 || pool.lock != CAPACITY) {
+    errors++;
+  }
+  sem_destroy(&pool);
+
+  // Five tasks waiting for two units each, released by a single call
+  sem_init(&gate, 0);
+  for (long i = 0; i < 5; i++) {
+    task_init(&(task[i]), gateBody, NULL);
+  }
+
+  task_sleep(10);
+  unsigned int wakeups = gate.num_wakeups;
+  sem_up_n(&gate, 9);
+  task_sleep(10);
+
+  // Only four of them can proceed with nine units
+  printf("%5d ms: main: %d tarefas acordadas\n", systime(), awake);
+  if (awake != 4 || gate.num_wakeups - wakeups != 4 || gate.lock != 1) {
+    errors++;
+  }
+
+  sem_up(&gate);
+  for (int i = 0; i < 5; i++) {
+    task_wait(&(task[i]));
+  }
+  sem_destroy(&gate);
+
+  // The unit released goes to the waiting task, with the same priority, even
+  // though this task asks for it again before leaving the processor
+  sem_init(&hand, 0);
+  task_init(&(task[0]), handBody, NULL);
+  task_sleep(10);
+  sem_up(&hand);
+  if (sem_down(&hand) < 0) {
+    errors++;
+  }
+  order[numOrder++] = 0;
+  sem_up(&hand);
+  task_wait(&(task[0]));
+
+  printf("%5d ms: main: unidade devolvida para %s\n", systime(),
+         order[0] ? "a tarefa esperando" : "a tarefa que liberou");
+  if (numOrder != 2 || order[0] != 1) {
+    errors++;
+  }
+  sem_destroy(&hand);
+
+  // A task waiting for every unit, while the others take them one at a time.
+  // Without yielding before suspending, only the units already taken are
+  // returned before the whole pool
+  sem_init(&stream, NUMTAKERS);
+  sem_spin(&stream, 0);
+  for (long i = 0; i < NUMTAKERS; i++) {
+    task_init(&(task[i]), takerBody, NULL);
+  }
+
+  task_sleep(5);
+  task_init(&(task[NUMTAKERS]), bulkBody, NULL);
+  for (int i = 0; i <= NUMTAKERS; i++) {
+    task_wait(&(task[i]));
+  }
+
+  printf("%5d ms: main: %d unidades tomadas antes do bloco\n", systime(),
+         passed);
+  if (passed < 0 || passed > NUMTAKERS) {
+    errors++;
+  }
+  sem_destroy(&stream);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
@@ -0,0 +1,185 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppsemaphore_prio.c
+ * Description: Test of the wait queues ordered by priority. Tasks with mixed
+ * priorities wait on a semaphore, a mutex and a message queue, and must be
+ * served by priority, and in arrival order between equal priorities, even when
+ * the priority of a waiting task changes.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMTASKS (8)
+
+task_t task[NUMTASKS];
+int prios[NUMTASKS] = {10, 0, 5, -5, 10, -5, 20, 0};
+semaphore_t s;
+mutex_t m;
+mqueue_t q;
+int arrived[NUMTASKS], numArrived = 0;
+int served[NUMTASKS], numServed = 0;
+int errors = 0;
+
+void semBody(void *arg) {
+  arrived[numArrived++] = (int)(long)arg;
+  if (sem_down(&s) < 0) {
+    errors++;
+  }
+  served[numServed++] = (int)(long)arg;
+  task_exit(0);
+}
+
+void mutexBody(void *arg) {
+  arrived[numArrived++] = (int)(long)arg;
+  if (mutex_lock(&m) < 0) {
+    errors++;
+  }
+  served[numServed++] = (int)(long)arg;
+  mutex_unlock(&m);
+  task_exit(0);
+}
+
+void mqueueBody(void *arg) {
+  int msg;
+  arrived[numArrived++] = (int)(long)arg;
+  if (mqueue_recv(&q, &msg) < 0) {
+    errors++;
+  }
+  served[numServed++] = (int)(long)arg;
+  task_exit(0);
+}
+
+/**
+ * Creates the tasks and lets every one of them start waiting.
+ */
+void start(void (*body)(void *)) {
+  numArrived = 0;
+  numServed = 0;
+  for (long i = 0; i < NUMTASKS; i++) {
+    task_init(&(task[i]), body, (void *)i);
+    task_setprio(&(task[i]), prios[i]);
+  }
+
+  task_sleep(20);
+}
+
+/**
+ * Checks that the tasks were served by priority, and in arrival order between
+ * the ones with the same priority.
+ */
+void check(const char *name) {
+  int expected[NUMTASKS], num = 0;
+  for (int prio = TASK_MIN_PRIO; prio <= TASK_MAX_PRIO; prio++) {
+    for (int i = 0; i < numArrived; i++) {
+      if (task_getprio(&(task[arrived[i]])) == prio) {
+        expected[num++] = arrived[i];
+      }
+    }
+  }
+
+  printf("%5d ms: main: %s:", systime(), name);
+  for (int i = 0; i < numServed; i++) {
+    printf(" %d", served[i]);
+  }
+  printf("\n");
+
+  if (numServed != NUMTASKS || num != NUMTASKS) {
+    errors++;
+    return;
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    if (served[i] != expected[i]) {
+      errors++;
+      return;
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  // Semaphore, released one unit at a time, where a waiting task also changes
+  // of priority
+  sem_init(&s, 0);
+  if (sem_setorder(&s, WAIT_PRIO) < 0) {
+    errors++;
+  }
+
+  start(semBody);
+  if (sem_setorder(&s, WAIT_FIFO) == 0) {
+    errors++;
+  }
+  task_setprio(&(task[6]), -10);
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    sem_up(&s);
+    task_sleep(5);
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_wait(&(task[i]));
+  }
+  check("semaforo");
+  sem_destroy(&s);
+
+  // Mutex, where a waiting task also changes of priority
+  mutex_init(&m);
+  if (mutex_setorder(&m, WAIT_PRIO) < 0) {
+    errors++;
+  }
+
+  mutex_lock(&m);
+  start(mutexBody);
+  task_setprio(&(task[6]), -10);
+  mutex_unlock(&m);
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_wait(&(task[i]));
+  }
+  check("mutex");
+  mutex_destroy(&m);
+
+  // Message queue, with one message sent at a time, where a waiting task also
+  // changes of priority
+  mqueue_init(&q, NUMTASKS, sizeof(int));
+  if (mqueue_setorder(&q, WAIT_PRIO) < 0) {
+    errors++;
+  }
+
+  start(mqueueBody);
+  task_setprio(&(task[6]), -10);
+
+  // The receivers are waiting, so neither of the orders can change
+  if (mqueue_setorder(&q, WAIT_FIFO) == 0 || q.sem_prod.order == NULL) {
+    errors++;
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    mqueue_send(&q, &i);
+    task_sleep(5);
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_wait(&(task[i]));
+  }
+  check("fila");
+  mqueue_destroy(&q);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
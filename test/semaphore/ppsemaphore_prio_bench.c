@@ -0,0 +1,110 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppsemaphore_prio_bench.c
+ * Description: Latency benchmark for the semaphore wait order. A task with a
+ * high priority takes a semaphore disputed by background tasks, once with the
+ * queue in FIFO order and once ordered by priority, and reports how long it
+ * waited for the unit.
+ * Usage: SemaphorePrioBench [background tasks] [rounds]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUMTASKS (100)
+#define NUMROUNDS (200)
+#define MAXTASKS (1000)
+
+task_t background[MAXTASKS], critical;
+semaphore_t sems[2];
+semaphore_t *s;
+unsigned long long latency[NUMROUNDS];
+int numTasks = NUMTASKS;
+int numRounds = NUMROUNDS;
+int stop = 0;
+
+void backgroundBody(void *arg) {
+  while (!stop) {
+    sem_down(s);
+    for (volatile int i = 0; i < 2000; i++) {
+    }
+    sem_up(s);
+
+    // Leaves the processor, so the unit goes to the first waiting task
+    task_yield();
+  }
+
+  task_exit(0);
+}
+
+void criticalBody(void *arg) {
+  for (int i = 0; i < numRounds; i++) {
+    task_sleep(2);
+    unsigned long long start = systime_ns();
+    sem_down(s);
+    latency[i] = systime_ns() - start;
+    sem_up(s);
+  }
+
+  stop = 1;
+  task_exit(0);
+}
+
+int compare(const void *ptr1, const void *ptr2) {
+  unsigned long long a = *(const unsigned long long *)ptr1;
+  unsigned long long b = *(const unsigned long long *)ptr2;
+  return (a > b) - (a < b);
+}
+
+void run(semaphore_t *sem, wait_policy policy, const char *name) {
+  s = sem;
+  stop = 0;
+  sem_init(s, 1);
+  sem_spin(s, 0);
+  sem_setorder(s, policy);
+
+  for (int i = 0; i < numTasks; i++) {
+    task_init(&(background[i]), backgroundBody, NULL);
+    task_setprio(&(background[i]), 10);
+  }
+
+  task_init(&critical, criticalBody, NULL);
+  task_setprio(&critical, -10);
+
+  task_wait(&critical);
+  for (int i = 0; i < numTasks; i++) {
+    task_wait(&(background[i]));
+  }
+  sem_destroy(s);
+
+  qsort(latency, (size_t)numRounds, sizeof(latency[0]), compare);
+  printf("%s: median %llu us, p99 %llu us, max %llu us\n", name,
+         latency[numRounds / 2] / 1000, latency[numRounds * 99 / 100] / 1000,
+         latency[numRounds - 1] / 1000);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 0 && atoi(argv[1]) <= MAXTASKS) {
+    numTasks = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) > 0 && atoi(argv[2]) <= NUMROUNDS) {
+    numRounds = atoi(argv[2]);
+  }
+
+  ppos_init();
+  task_setprio(NULL, -20);
+
+  printf("background tasks: %d, rounds: %d\n", numTasks, numRounds);
+  run(&(sems[0]), WAIT_FIFO, "fifo");
+  run(&(sems[1]), WAIT_PRIO, "prio");
+
+  task_exit(0);
+}
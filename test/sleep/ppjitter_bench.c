@@ -0,0 +1,115 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppjitter_bench.c
+ * Description: Jitter benchmark of the periodic wakeups. A task with a high
+ * priority executes a periodic loop while CPU-bound tasks use the processor,
+ * once sleeping the period after each iteration and once sleeping until the
+ * next deadline, and reports the distribution of the lateness of each wakeup
+ * relative to its ideal time, and the drift at the end of the loop.
+ * Usage: JitterBench [periods] [period in us] [CPU-bound tasks]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUMPERIODS (1000)
+#define MAXPERIODS (100000)
+#define PERIOD (5000) // In microseconds
+#define NUMHOGS (2)
+#define MAXHOGS (100)
+
+task_t hogs[MAXHOGS];
+long long lateness[MAXPERIODS];
+int numPeriods = NUMPERIODS;
+int period = PERIOD;
+int numHogs = NUMHOGS;
+volatile int stop = 0;
+
+void hogBody(void *arg) {
+  while (!stop) {
+  }
+
+  task_exit(0);
+}
+
+/**
+ * Keeps the processor busy for a number of nanoseconds.
+ */
+void busy(unsigned long long time) {
+  unsigned long long start = systime_ns();
+  while (systime_ns() - start < time) {
+  }
+}
+
+int compare(const void *ptr1, const void *ptr2) {
+  long long a = *(const long long *)ptr1;
+  long long b = *(const long long *)ptr2;
+  return (a > b) - (a < b);
+}
+
+void run(int absolute, const char *name) {
+  unsigned long long periodNs = (unsigned long long)period * 1000;
+  unsigned long long start = systime_ns();
+  unsigned long long deadline = start;
+
+  for (int i = 0; i < numPeriods; i++) {
+    // Executes for a part of the period
+    busy(periodNs * 3 / 10);
+    if (absolute) {
+      task_sleep_next(&deadline, periodNs);
+    } else {
+      task_sleep(period / 1000);
+    }
+
+    unsigned long long ideal = start + (unsigned long long)(i + 1) * periodNs;
+    lateness[i] = (long long)(systime_ns() - ideal);
+  }
+
+  long long drift = lateness[numPeriods - 1];
+  qsort(lateness, (size_t)numPeriods, sizeof(lateness[0]), compare);
+  printf("%s: lateness min %lld us, median %lld us, p99 %lld us, max %lld us, "
+         "drift %lld us\n",
+         name, lateness[0] / 1000, lateness[numPeriods / 2] / 1000,
+         lateness[numPeriods * 99 / 100] / 1000,
+         lateness[numPeriods - 1] / 1000, drift / 1000);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 0 && atoi(argv[1]) <= MAXPERIODS) {
+    numPeriods = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) >= 1000) {
+    period = atoi(argv[2]);
+  }
+
+  if (argc > 3 && atoi(argv[3]) >= 0 && atoi(argv[3]) <= MAXHOGS) {
+    numHogs = atoi(argv[3]);
+  }
+
+  ppos_init();
+  task_setprio(NULL, TASK_MIN_PRIO);
+
+  for (int i = 0; i < numHogs; i++) {
+    task_init(&(hogs[i]), hogBody, NULL);
+  }
+
+  printf("periods: %d, period: %d us, CPU-bound tasks: %d\n", numPeriods,
+         period, numHogs);
+  run(0, "relative");
+  run(1, "absolute");
+
+  stop = 1;
+  for (int i = 0; i < numHogs; i++) {
+    task_wait(&(hogs[i]));
+  }
+
+  task_exit(0);
+}
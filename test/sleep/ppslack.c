@@ -0,0 +1,96 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppslack.c
+ * Description: Test of the slack of the wakeups. Tasks with slack that sleep
+ * until close times must be awakened together, never before their sleep time
+ * and never after the slack, while a task without slack is awakened on time.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMTASKS (10)
+#define SLEEPTIME (50)
+#define SLACK (20)
+
+task_t tasks[NUMTASKS], exact;
+unsigned int wakeup[NUMTASKS];
+int errors = 0;
+
+void slackBody(void *arg) {
+  long i = (long)arg;
+  int time = SLEEPTIME + (int)i;
+
+  unsigned int before = systime();
+  task_sleep(time);
+  wakeup[i] = systime();
+
+  if (wakeup[i] - before < (unsigned int)time
+      || wakeup[i] - before > (unsigned int)(time + SLACK)) {
+    errors++;
+  }
+
+  task_exit(0);
+}
+
+void exactBody(void *arg) {
+  // Awakened before the others could be, so it does not wake them up
+  unsigned int before = systime();
+  task_sleep(SLEEPTIME / 2);
+  if (systime() - before != SLEEPTIME / 2) {
+    errors++;
+  }
+
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  for (long i = 0; i < NUMTASKS; i++) {
+    task_init(&(tasks[i]), slackBody, (void *)i);
+    if (task_set_slack(&(tasks[i]), SLACK) < 0) {
+      errors++;
+    }
+  }
+  task_init(&exact, exactBody, NULL);
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    task_wait(&(tasks[i]));
+  }
+  task_wait(&exact);
+
+  // All the sleep times are within the slack of the first one
+  int ticks = 1;
+  for (int i = 1; i < NUMTASKS; i++) {
+    if (wakeup[i] != wakeup[i - 1]) {
+      ticks++;
+    }
+  }
+
+  printf("%5d ms: main: %d tarefas acordadas em %d ticks\n", systime(),
+         NUMTASKS, ticks);
+  if (ticks != 1) {
+    errors++;
+  }
+
+  if (task_set_slack(NULL, -1) == 0 || task_set_slack(NULL, 0) < 0) {
+    errors++;
+  }
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
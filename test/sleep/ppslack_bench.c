@@ -0,0 +1,123 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppslack_bench.c
+ * Description: Benchmark of the coalescing of wakeups. A number of tasks sleep
+ * repeatedly for slightly different times, once without slack and once with
+ * it, and reports the ticks where tasks were awakened, each one a pass of the
+ * dispatcher, the wakeups, their average delay, and the processor used by the
+ * whole process.
+ * Usage: SlackBench [sleepers] [slack in ms] [time in ms]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#define NUMSLEEPERS (1000)
+#define MAXSLEEPERS (10000)
+#define SLACK (10)
+#define RUNTIME (2000)
+#define SLEEPTIME (20)
+
+task_t sleepers[MAXSLEEPERS];
+int numSleepers = NUMSLEEPERS;
+int slack = SLACK;
+int runTime = RUNTIME;
+volatile int stop = 0;
+unsigned int lastWakeup = 0;
+int wakeupTicks = 0;
+int wakeups = 0;
+unsigned long long delay = 0;
+
+void sleeperBody(void *arg) {
+  int time = SLEEPTIME + (int)(long)arg % SLEEPTIME;
+
+  while (!stop) {
+    unsigned int before = systime();
+    task_sleep(time);
+
+    preempt_disable();
+    unsigned int now = systime();
+    if (now != lastWakeup) {
+      lastWakeup = now;
+      wakeupTicks++;
+    }
+    wakeups++;
+    delay += now - before - (unsigned int)time;
+    preempt_enable();
+  }
+
+  task_exit(0);
+}
+
+/**
+ * Gets the processor time used by the process, in nanoseconds.
+ */
+unsigned long long cputime() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (unsigned long long)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+           * 1000000000ULL
+         + (unsigned long long)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec)
+             * 1000ULL;
+}
+
+void run(int taskSlack) {
+  stop = 0;
+  for (long i = 0; i < numSleepers; i++) {
+    task_init(&(sleepers[i]), sleeperBody, (void *)i);
+    task_set_slack(&(sleepers[i]), taskSlack);
+  }
+
+  // Measures once all the tasks are sleeping
+  task_sleep(2 * SLEEPTIME);
+  wakeupTicks = 0;
+  wakeups = 0;
+  delay = 0;
+
+  unsigned long long start = systime_ns();
+  unsigned long long startCpu = cputime();
+  task_sleep(runTime);
+  unsigned long long elapsed = systime_ns() - start;
+  unsigned long long cpu = cputime() - startCpu;
+
+  printf("slack: %3d ms, %6d wakeup ticks, %7d wakeups, %5.2f ms delay, "
+         "%5.1f%% of the processor\n",
+         taskSlack, wakeupTicks, wakeups,
+         wakeups ? (double)delay / (double)wakeups : 0.0,
+         100.0 * (double)cpu / (double)elapsed);
+
+  stop = 1;
+  for (int i = 0; i < numSleepers; i++) {
+    task_wait(&(sleepers[i]));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 0 && atoi(argv[1]) <= MAXSLEEPERS) {
+    numSleepers = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) >= 0) {
+    slack = atoi(argv[2]);
+  }
+
+  if (argc > 3 && atoi(argv[3]) > 0) {
+    runTime = atoi(argv[3]);
+  }
+
+  ppos_init();
+
+  printf("sleepers: %d, time: %d ms\n", numSleepers, runTime);
+  run(0);
+  run(slack);
+
+  task_exit(0);
+}
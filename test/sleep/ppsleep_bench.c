@@ -0,0 +1,107 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppsleep_bench.c
+ * Description: Throughput benchmark of a CPU-bound task while other tasks are
+ * sleeping. The main task sleeps through the measurement, once alone and once
+ * with a number of other tasks sleeping longer than it, and reports the loops
+ * executed by the CPU-bound task, the times it was dispatched and the share of
+ * the processor it got.
+ * Usage: SleepBench [sleepers] [time in ms]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUMSLEEPERS (10000)
+#define MAXSLEEPERS (10000)
+#define RUNTIME (1000)
+
+task_t sleepers[MAXSLEEPERS], hog;
+int numSleepers = NUMSLEEPERS;
+int runTime = RUNTIME;
+volatile int stop = 0;
+int numStarted = 0;
+volatile unsigned long long loops = 0;
+
+void sleeperBody(void *arg) {
+  // Wakes up only after the measurement, even if starting all of them takes
+  // a while
+  preempt_disable();
+  numStarted++;
+  preempt_enable();
+  task_sleep(2 * runTime + (int)(long)arg % 100);
+  task_exit(0);
+}
+
+void hogBody(void *arg) {
+  while (!stop) {
+    loops++;
+  }
+
+  task_exit(0);
+}
+
+void run(int num) {
+  numStarted = 0;
+  for (long i = 0; i < num; i++) {
+    task_init(&(sleepers[i]), sleeperBody, (void *)i);
+  }
+
+  // Lets the sleepers start sleeping
+  unsigned int begin = systime();
+  while (numStarted < num) {
+    task_sleep(1);
+  }
+
+  if (num) {
+    printf("sleepers started in %u ms\n", systime() - begin);
+  }
+
+  stop = 0;
+  loops = 0;
+  task_init(&hog, hogBody, NULL);
+
+  unsigned long long start = systime_ns();
+  task_sleep(runTime);
+  stop = 1;
+  unsigned long long elapsed = systime_ns() - start;
+
+  task_times_t times;
+  task_times(&hog, &times);
+  printf("sleepers: %5d, %7.0f loops/ms, %5u activations, %5.1f%% of the "
+         "processor\n",
+         num + 1, (double)loops / ((double)elapsed / 1000000.0), hog.num_calls,
+         100.0 * (double)times.run / (double)elapsed);
+
+  task_wait(&hog);
+  for (int i = 0; i < num; i++) {
+    task_wait(&(sleepers[i]));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) >= 0 && atoi(argv[1]) <= MAXSLEEPERS) {
+    numSleepers = atoi(argv[1]);
+  }
+
+  if (argc > 2 && atoi(argv[2]) > 0) {
+    runTime = atoi(argv[2]);
+  }
+
+  ppos_init();
+
+  printf("time: %d ms\n", runTime);
+
+  // The main task is the only one sleeping
+  run(0);
+  run(numSleepers);
+
+  task_exit(0);
+}
@@ -0,0 +1,117 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppsleepuntil.c
+ * Description: Test of the sleep until an absolute time. A periodic loop that
+ * executes for part of each period must never wake up before its deadlines,
+ * and must end at the time of the last one, without the drift of the relative
+ * sleep. A deadline that already passed must return immediately.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMPERIODS (100)
+#define PERIOD (3000000ULL) // 3 ms in nanoseconds
+#define WORK (1000000ULL)   // 1 ms in nanoseconds
+#define TOLERANCE (5000000ULL)
+
+task_t hog;
+volatile int stop = 0;
+int errors = 0;
+
+/**
+ * Keeps the processor busy for a number of nanoseconds.
+ */
+void busy(unsigned long long time) {
+  unsigned long long start = systime_ns();
+  while (systime_ns() - start < time) {
+  }
+}
+
+void hogBody(void *arg) {
+  while (!stop) {
+  }
+
+  task_exit(0);
+}
+
+/**
+ * Executes a periodic loop, and returns the time after the last period.
+ */
+unsigned long long periodic(int relative, int *early) {
+  unsigned long long deadline = systime_ns();
+  for (int i = 0; i < NUMPERIODS; i++) {
+    busy(WORK);
+    if (relative) {
+      task_sleep((int)(PERIOD / 1000000));
+      continue;
+    }
+
+    if (task_sleep_next(&deadline, PERIOD) < 0) {
+      errors++;
+    }
+
+    if (systime_ns() < deadline) {
+      (*early)++;
+    }
+  }
+
+  return systime_ns();
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  // A task that competes for the processor with a lower priority
+  task_init(&hog, hogBody, NULL);
+  task_setprio(&hog, TASK_MAX_PRIO);
+  task_setprio(NULL, TASK_MIN_PRIO);
+
+  int early = 0;
+  unsigned long long start = systime_ns();
+  unsigned long long elapsed = periodic(0, &early) - start;
+  unsigned long long expected = NUMPERIODS * PERIOD;
+  printf("%5d ms: main: absoluto: %llu us para %llu us, %d antes do prazo\n",
+         systime(), elapsed / 1000, expected / 1000, early);
+  if (early || elapsed < expected || elapsed - expected > TOLERANCE) {
+    errors++;
+  }
+
+  // The relative sleep drifts with the execution time of each period
+  start = systime_ns();
+  elapsed = periodic(1, &early) - start;
+  printf("%5d ms: main: relativo: %llu us para %llu us\n", systime(),
+         elapsed / 1000, expected / 1000);
+
+  // A deadline in the past returns without sleeping
+  start = systime_ns();
+  if (task_sleep_until(start - PERIOD) != 1 || task_sleep_until(0) != 1
+      || systime_ns() - start > WORK) {
+    errors++;
+  }
+
+  unsigned long long deadline = systime_ns();
+  if (task_sleep_next(NULL, PERIOD) != -1
+      || task_sleep_next(&deadline, 0) != -1) {
+    errors++;
+  }
+
+  stop = 1;
+  task_wait(&hog);
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
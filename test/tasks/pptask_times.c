@@ -0,0 +1,115 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: pptask_times.c
+ * Description: Test of the time accounting of the tasks. A task that only
+ * executes in bursts shorter than a tick must still be charged, a sleeping task
+ * must be charged as blocked, and the states must add up to the lifetime of
+ * each task.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMYIELDS (2000)
+#define SLEEPTIME (50)
+#define BUSYTIME (40)
+
+task_t yielder, sleeper, busy;
+task_times_t times[3];
+unsigned long long lifetime[3];
+int errors = 0;
+
+void yielderBody(void *arg) {
+  unsigned long long start = systime_ns();
+  for (int i = 0; i < NUMYIELDS; i++) {
+    task_yield();
+  }
+
+  task_times(NULL, &(times[0]));
+  lifetime[0] = systime_ns() - start;
+  task_exit(0);
+}
+
+void sleeperBody(void *arg) {
+  unsigned long long start = systime_ns();
+  task_sleep(SLEEPTIME);
+
+  task_times(NULL, &(times[1]));
+  lifetime[1] = systime_ns() - start;
+  task_exit(0);
+}
+
+void busyBody(void *arg) {
+  unsigned long long start = systime_ns();
+  while (systime_ns() - start < BUSYTIME * 1000000ULL) {
+  }
+
+  task_times(NULL, &(times[2]));
+  lifetime[2] = systime_ns() - start;
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  task_init(&yielder, yielderBody, NULL);
+  task_init(&sleeper, sleeperBody, NULL);
+  task_init(&busy, busyBody, NULL);
+
+  task_wait(&yielder);
+  task_wait(&sleeper);
+  task_wait(&busy);
+
+  const char *names[] = {"yielder", "sleeper", "busy"};
+  for (int i = 0; i < 3; i++) {
+    unsigned long long total = times[i].run + times[i].ready + times[i].blocked;
+    printf("%5d ms: main: %s: run %llu us, ready %llu us, blocked %llu us\n",
+           systime(), names[i], times[i].run / 1000, times[i].ready / 1000,
+           times[i].blocked / 1000);
+
+    // The task was initialized a little before it started
+    if (total < lifetime[i]) {
+      errors++;
+    }
+  }
+
+  // Each burst of the yielder is shorter than a tick
+  if (times[0].run == 0) {
+    errors++;
+  }
+
+  if (times[1].blocked < (SLEEPTIME - 1) * 1000000ULL
+      || times[1].run > times[1].blocked) {
+    errors++;
+  }
+
+  if (times[2].run < BUSYTIME * 1000000ULL / 2) {
+    errors++;
+  }
+
+  // The main task was blocked while waiting
+  task_times_t mainTimes;
+  if (task_times(NULL, &mainTimes) < 0 || mainTimes.blocked == 0) {
+    errors++;
+  }
+
+  if (task_times(NULL, NULL) == 0) {
+    errors++;
+  }
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
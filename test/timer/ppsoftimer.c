@@ -0,0 +1,163 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppsoftimer.c
+ * Description: Test of the software timers. One-shot and periodic timers must
+ * expire on time, thousands of timers must fire in the order they expire,
+ * cancelled timers must not fire, and a callback must be able to wake a task
+ * and to cancel its own timer.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+
+#define NUMTIMERS (5000)
+#define NUMCANCEL (1000)
+#define ONESHOT (50)
+#define PERIOD (10)
+#define SELFCANCEL (3)
+
+ppos_timer_t timers[NUMTIMERS];
+ppos_timer_t oneshot, periodic, selfcancel, waker;
+semaphore_t s;
+unsigned int firedAt = 0;
+int numFired = 0;
+int outOfOrder = 0;
+unsigned int lastExpire = 0;
+int errors = 0;
+
+void oneshotCallback(void *arg) { firedAt = systime(); }
+
+void countCallback(void *arg) { numFired++; }
+
+void orderCallback(void *arg) {
+  ppos_timer_t *timer = (ppos_timer_t *)arg;
+
+  // Expires after the last one and not before its time
+  if (timer->expire < lastExpire || systime() < timer->expire) {
+    outOfOrder++;
+  }
+
+  lastExpire = timer->expire;
+  numFired++;
+}
+
+void selfCancelCallback(void *arg) {
+  ppos_timer_t *timer = (ppos_timer_t *)arg;
+  if (timer->num_fired == SELFCANCEL && ppos_timer_cancel(timer) < 0) {
+    errors++;
+  }
+}
+
+void wakerCallback(void *arg) { sem_up(&s); }
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  // One-shot timer
+  unsigned int start = systime();
+  if (ppos_timer_create(&oneshot, ONESHOT, 0, oneshotCallback, NULL) < 0
+      || ppos_timer_create(&oneshot, ONESHOT, 0, oneshotCallback, NULL) == 0) {
+    errors++;
+  }
+
+  task_sleep(2 * ONESHOT);
+  printf("%5d ms: main: disparo unico apos %u ms\n", systime(),
+         firedAt - start);
+  if (!firedAt || firedAt - start < ONESHOT || oneshot.num_fired != 1
+      || ppos_timer_cancel(&oneshot) == 0) {
+    errors++;
+  }
+
+  // Periodic timer, cancelled by the main task
+  numFired = 0;
+  ppos_timer_create(&periodic, PERIOD, PERIOD, countCallback, NULL);
+  task_sleep(10 * PERIOD + PERIOD / 2);
+  if (ppos_timer_cancel(&periodic) < 0) {
+    errors++;
+  }
+
+  int fired = numFired;
+  task_sleep(3 * PERIOD);
+  printf("%5d ms: main: %d disparos periodicos\n", systime(), fired);
+  if (fired < 9 || fired > 11 || numFired != fired) {
+    errors++;
+  }
+
+  // Periodic timer cancelled by its own callback
+  ppos_timer_create(&selfcancel, 1, 1, selfCancelCallback, &selfcancel);
+  task_sleep(20);
+  if (selfcancel.num_fired != SELFCANCEL) {
+    errors++;
+  }
+
+  // Thousands of timers armed out of order
+  numFired = 0;
+  for (int i = 0; i < NUMTIMERS; i++) {
+    int delay = (i * 7919) % 100;
+    if (ppos_timer_create(&(timers[i]), delay, 0, orderCallback,
+                          &(timers[i]))
+        < 0) {
+      errors++;
+    }
+  }
+
+  task_sleep(150);
+  printf("%5d ms: main: %d de %d disparados, %d fora de ordem\n", systime(),
+         numFired, NUMTIMERS, outOfOrder);
+  if (numFired != NUMTIMERS || outOfOrder) {
+    errors++;
+  }
+
+  // Half of the timers cancelled before expiring
+  numFired = 0;
+  int cancelled = 0;
+  for (int i = 0; i < NUMCANCEL; i++) {
+    ppos_timer_create(&(timers[i]), 20 + i % 30, 0, countCallback, NULL);
+  }
+
+  for (int i = 0; i < NUMCANCEL; i += 2) {
+    if (ppos_timer_cancel(&(timers[i])) == 0) {
+      cancelled++;
+    }
+  }
+
+  task_sleep(100);
+  printf("%5d ms: main: %d cancelados, %d disparados\n", systime(), cancelled,
+         numFired);
+  if (cancelled != NUMCANCEL / 2 || numFired != NUMCANCEL / 2) {
+    errors++;
+  }
+
+  // A callback wakes the main task
+  sem_init(&s, 0);
+  start = systime();
+  ppos_timer_create(&waker, 30, 0, wakerCallback, NULL);
+  sem_down(&s);
+  printf("%5d ms: main: acordada apos %u ms\n", systime(), systime() - start);
+  if (systime() - start < 30) {
+    errors++;
+  }
+  sem_destroy(&s);
+
+  if (ppos_timer_create(NULL, 0, 0, countCallback, NULL) == 0
+      || ppos_timer_create(&oneshot, -1, 0, countCallback, NULL) == 0
+      || ppos_timer_create(&oneshot, 0, 0, NULL, NULL) == 0) {
+    errors++;
+  }
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}
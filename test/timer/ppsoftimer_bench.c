@@ -0,0 +1,86 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppsoftimer_bench.c
+ * Description: Benchmark of the software timers against sleeping tasks. Arms
+ * a number of timeouts, first as tasks that sleep and then as software timers,
+ * and reports the time to arm them, the time until the last one expired and the
+ * memory used by each.
+ * Usage: SoftTimerBench [timeouts]
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+#include "ppos_data.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUMTIMEOUTS (1000)
+#define MAXTIMEOUTS (10000)
+#define TIMEOUT (100)
+
+task_t tasks[MAXTIMEOUTS];
+ppos_timer_t timers[MAXTIMEOUTS];
+int numTimeouts = NUMTIMEOUTS;
+int numExpired = 0;
+unsigned long long lastExpired = 0;
+
+void expire() {
+  numExpired++;
+  lastExpired = systime_ns();
+}
+
+void taskBody(void *arg) {
+  task_sleep(TIMEOUT + (int)(long)arg % 10);
+  expire();
+  task_exit(0);
+}
+
+void timerCallback(void *arg) { expire(); }
+
+void report(const char *name, unsigned long long start,
+            unsigned long long armed, size_t memory) {
+  printf("%s: arm %llu us, last expired at %llu ms, %d expired, %zu KiB\n",
+         name, (armed - start) / 1000, (lastExpired - start) / 1000000,
+         numExpired, memory / 1024);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && atoi(argv[1]) > 0 && atoi(argv[1]) <= MAXTIMEOUTS) {
+    numTimeouts = atoi(argv[1]);
+  }
+
+  ppos_init();
+
+  printf("timeouts: %d\n", numTimeouts);
+
+  numExpired = 0;
+  unsigned long long start = systime_ns();
+  for (long i = 0; i < numTimeouts; i++) {
+    task_init(&(tasks[i]), taskBody, (void *)i);
+  }
+  unsigned long long armed = systime_ns();
+
+  for (int i = 0; i < numTimeouts; i++) {
+    task_wait(&(tasks[i]));
+  }
+  report("tasks", start, armed,
+         (size_t)numTimeouts * (sizeof(task_t) + STACKSIZE));
+
+  numExpired = 0;
+  start = systime_ns();
+  for (int i = 0; i < numTimeouts; i++) {
+    ppos_timer_create(&(timers[i]), TIMEOUT + i % 10, 0, timerCallback, NULL);
+  }
+  armed = systime_ns();
+
+  while (numExpired < numTimeouts) {
+    task_sleep(1);
+  }
+  report("timers", start, armed, (size_t)numTimeouts * sizeof(ppos_timer_t));
+
+  task_exit(0);
+}
@@ -0,0 +1,130 @@
+/*
+ * PingPongOS - PingPong Operating System
+ * Filename: ppwait_group.c
+ * Description: Test of task_wait_any, task_wait_all and the futures. The
+ * workers sleep different times and exit with their own codes, and a server
+ * answers requests through futures instead of a message queue.
+ *
+ * Author: Victor Briganti
+ * Date: 2026-10-18
+ * License: BSD 2
+ */
+
+#include "ppos.h"
+
+#include <stdio.h>
+
+#define NUMTASKS (8)
+#define NUMCLIENTS (4)
+
+task_t workers[NUMTASKS], clients[NUMCLIENTS], server;
+task_t *set[NUMTASKS];
+future_t requests[NUMCLIENTS], responses[NUMCLIENTS];
+long int answers[NUMCLIENTS];
+int errors = 0;
+
+void workerBody(void *arg) {
+  int id = (int)(long)arg;
+
+  // The worker 3 is the fastest one
+  task_sleep(id == 3 ? 5 : 20 + id * 5);
+  task_exit(100 + id);
+}
+
+void serverBody(void *arg) {
+  for (int i = 0; i < NUMCLIENTS; i++) {
+    void *request;
+    future_get(&(requests[i]), &request);
+    future_complete(&(responses[i]), (void *)((long)request * 2));
+  }
+
+  task_exit(0);
+}
+
+void clientBody(void *arg) {
+  int id = (int)(long)arg;
+  void *response;
+
+  future_complete(&(requests[id]), (void *)(long)(id + 1));
+  if (future_get(&(responses[id]), &response) < 0) {
+    errors++;
+  }
+
+  answers[id] = (long)response;
+  task_exit(0);
+}
+
+int main(int argc, char *argv[]) {
+  ppos_init();
+
+  printf("%5d ms: main: inicio\n", systime());
+
+  for (long i = 0; i < NUMTASKS; i++) {
+    task_init(&(workers[i]), workerBody, (void *)i);
+    set[i] = &(workers[i]);
+  }
+
+  int code;
+  int first = task_wait_any(set, NUMTASKS, &code);
+  printf("%5d ms: main: primeira tarefa %d, codigo %d\n", systime(), first,
+         code);
+  if (first != 3 || code != 103) {
+    errors++;
+  }
+
+  int codes[NUMTASKS];
+  if (task_wait_all(set, NUMTASKS, codes) < 0) {
+    errors++;
+  }
+
+  for (int i = 0; i < NUMTASKS; i++) {
+    if (codes[i] != 100 + i) {
+      errors++;
+    }
+  }
+  printf("%5d ms: main: todas terminaram\n", systime());
+
+  // Waiting tasks that already finished returns right away
+  if (task_wait_any(set, NUMTASKS, &code) < 0 ||
+      task_wait_all(set, NUMTASKS, NULL) < 0) {
+    errors++;
+  }
+
+  for (int i = 0; i < NUMCLIENTS; i++) {
+    future_init(&(requests[i]));
+    future_init(&(responses[i]));
+  }
+
+  task_init(&server, serverBody, NULL);
+  for (long i = 0; i < NUMCLIENTS; i++) {
+    task_init(&(clients[i]), clientBody, (void *)i);
+  }
+
+  task_t *all[NUMCLIENTS + 1] = {&server};
+  for (int i = 0; i < NUMCLIENTS; i++) {
+    all[i + 1] = &(clients[i]);
+  }
+  task_wait_all(all, NUMCLIENTS + 1, NULL);
+
+  for (int i = 0; i < NUMCLIENTS; i++) {
+    if (answers[i] != (i + 1) * 2 || future_done(&(responses[i])) != 1) {
+      errors++;
+    }
+
+    // A future is completed only once
+    if (future_complete(&(responses[i]), NULL) == 0) {
+      errors++;
+    }
+
+    future_destroy(&(requests[i]));
+    future_destroy(&(responses[i]));
+  }
+
+  printf("%5d ms: main: %d erros\n", systime(), errors);
+  if (errors) {
+    task_exit(1);
+  }
+
+  printf("%5d ms: main: fim\n", systime());
+  task_exit(0);
+}